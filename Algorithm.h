@@ -2,6 +2,7 @@
 #define _ALGORITHM_H_
 
 #include <string>
+#include <utility>
 #include "Iterator.h"
 #include "TypeTraits.h"
 
@@ -58,111 +59,219 @@ namespace miniSTL
 	}
 
 	/*
-	* make_heap
-	* Algorithm Complexity: O(N)
+	* heap policies
+	* the shape of the implicit heap: node i has Arity children stored side by side from
+	* Arity * i + 1. a 4-ary heap is half as deep as a binary one and finds all children of a
+	* node of ints in one cache line, at the price of more comparisons per level.
+	* every heap algorithm takes the policy as a last argument, binary when it is left out
 	*/
-	template<class RandomAccessIterator, class Compare>
-	static void up(RandomAccessIterator first, RandomAccessIterator last,
-	RandomAccessIterator head, Compare comp) 
+	template <int Arity>
+	struct dary_heap_policy {
+		static_assert(Arity >= 2, "a heap node needs at least two children");
+		static const int arity = Arity;
+
+		template <class Distance>
+		static Distance parent(Distance i) { return (i - 1) / Arity; }
+		template <class Distance>
+		static Distance first_child(Distance i) { return i * Arity + 1; }
+	};
+
+	typedef dary_heap_policy<2> binary_heap_policy;
+
+	namespace Detail
 	{
-		if (first != last) 
+		//heap_up and heap_down report each element they move as moved(element, new index), which
+		//lets an indexed heap keep the position of every element. the heap algorithms track nothing
+		struct heap_untracked {
+			template<class T, class Distance>
+			void operator()(const T&, Distance) const {}
+		};
+
+		//fill the hole at idx with val, moving down each ancestor that orders before val,
+		//returns where val went
+		template<class RandomAccessIterator, class Distance, class T, class Compare, class HeapPolicy, class Moved>
+		Distance heap_hole_up(RandomAccessIterator head, Distance idx, T& val, Compare comp, HeapPolicy, Moved moved)
 		{
-			int idx = last - head - 1;
-			auto pIdx = (idx - 1) / 2;
+			while (idx > 0) {
+				Distance pIdx = HeapPolicy::parent(idx);
+				if (!comp(head[pIdx], val))
+					break;
+				head[idx] = std::move(head[pIdx]);
+				moved(head[idx], idx);
+				idx = pIdx;
+			}
+			head[idx] = std::move(val);
+			moved(head[idx], idx);
+			return idx;
+		}
 
-			for (auto cur = last - 1; pIdx >= 0 && cur != head; pIdx = (idx - 1) / 2) 
-			{
-				auto parent = head + pIdx;
-				if (comp(*parent, *cur))
-					miniSTL::swap(*parent, *cur);
-				cur = parent;
-				idx = cur - head;
+		//the child of idx that orders last, idx must have one in [head, head + len)
+		template<class RandomAccessIterator, class Distance, class Compare, class HeapPolicy>
+		Distance heap_best_child(RandomAccessIterator head, Distance idx, Distance len, Compare comp, HeapPolicy)
+		{
+			const Distance cIdx = HeapPolicy::first_child(idx);
+			const Distance cEnd = len - cIdx > HeapPolicy::arity ? cIdx + HeapPolicy::arity : len;
+			Distance best = cIdx;
+			//a select rather than a branch, which child wins is a coin flip for random keys
+			for (Distance c = cIdx + 1; c < cEnd; ++c)
+				best = comp(head[best], head[c]) ? c : best;
+			return best;
+		}
+
+		//move the element at idx towards the root while its parent orders before it,
+		//returns where it stopped. the element waits in a temporary and each ancestor it
+		//passes is moved down once, a move per level instead of the three of a swap
+		template<class RandomAccessIterator, class Distance, class Compare, class HeapPolicy, class Moved>
+		Distance heap_up(RandomAccessIterator head, Distance idx, Compare comp, HeapPolicy policy, Moved moved)
+		{
+			if (idx == 0 || !comp(head[HeapPolicy::parent(idx)], head[idx])) {
+				moved(head[idx], idx);
+				return idx;
 			}
+			auto val = std::move(head[idx]);
+			return heap_hole_up(head, idx, val, comp, policy, moved);
 		}
-	}
 
-	template<class RandomAccessIterator, class Compare>
-	static void down(RandomAccessIterator first, RandomAccessIterator last,
-	RandomAccessIterator head, Compare comp)
-	{
-		if (first != last) 
+		//move the element at idx towards the leaves of the heap [head, head + len) while
+		//its largest child orders after it, through a hole like heap_up
+		template<class RandomAccessIterator, class Distance, class Compare, class HeapPolicy, class Moved>
+		void heap_down(RandomAccessIterator head, Distance idx, Distance len, Compare comp, HeapPolicy policy, Moved moved)
 		{
-			auto idx = first - head;
-			auto cIdx = idx * 2 + 1;
-			for (auto cur = first; cIdx < (last - head) && cur != last; cIdx = idx * 2 + 1) 
-			{
-				auto child = head + cIdx;
-				if ((child + 1) < last && *(child + 1) > *child)
-					child = child + 1;
-
-				if (comp(*cur, *child))
-					miniSTL::swap(*cur, *child);
-				cur = child;
-				idx = cur - head;
+			if (HeapPolicy::first_child(idx) >= len) {
+				if (idx < len)
+					moved(head[idx], idx);
+				return;
 			}
+			Distance best = heap_best_child(head, idx, len, comp, policy);
+			if (!comp(head[idx], head[best])) {
+				moved(head[idx], idx);
+				return;
+			}
+			auto val = std::move(head[idx]);
+			do {
+				head[idx] = std::move(head[best]);
+				moved(head[idx], idx);
+				idx = best;
+				if (HeapPolicy::first_child(idx) >= len)
+					break;
+				best = heap_best_child(head, idx, len, comp, policy);
+			} while (comp(val, head[best]));
+			head[idx] = std::move(val);
+			moved(head[idx], idx);
+		}
+
+		//fill the hole at idx of the heap [head, head + len) with val, Floyd's way: the hole
+		//sinks to a leaf along the best children without looking at val, then val climbs back
+		//from there, past idx if it has to. val is usually a former last element and belongs
+		//near the leaves, so the climb is short and each level on the way down saves the
+		//comparison with val that a plain sift pays
+		template<class RandomAccessIterator, class Distance, class T, class Compare, class HeapPolicy, class Moved>
+		void heap_fill_hole(RandomAccessIterator head, Distance idx, Distance len, T& val, Compare comp, HeapPolicy policy, Moved moved)
+		{
+			while (HeapPolicy::first_child(idx) < len) {
+				const Distance best = heap_best_child(head, idx, len, comp, policy);
+				head[idx] = std::move(head[best]);
+				moved(head[idx], idx);
+				idx = best;
+			}
+			heap_hole_up(head, idx, val, comp, policy, moved);
 		}
 	}
 
-	template <class RandomAccessIterator>
-	void make_heap(RandomAccessIterator first, RandomAccessIterator last) {
-		make_heap(first, last,
-			typename miniSTL::less<miniSTL::iterator_traits<RandomAccessIterator>::value_type>());
+	/*
+	* make_heap
+	* Algorithm Complexity: O(N)
+	*/
+	//sift down every inner node, the last one first
+	template <class RandomAccessIterator, class Compare, class HeapPolicy>
+	void make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp, HeapPolicy policy) {
+		const auto len = last - first;
+		if (len < 2)
+			return;
+		for (auto idx = HeapPolicy::parent(len - 1); ; --idx) {
+			Detail::heap_down(first, idx, len, comp, policy, Detail::heap_untracked());
+			if (idx == 0)
+				break;
+		}
 	}
 
 	template <class RandomAccessIterator, class Compare>
 	void make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
-		const auto range = last - first;
-		for (auto cur = first + range / 2; cur >= first; --cur) {
-			down(cur, last, first, comp);
-		}
+		miniSTL::make_heap(first, last, comp, binary_heap_policy());
+	}
+
+	template <class RandomAccessIterator>
+	void make_heap(RandomAccessIterator first, RandomAccessIterator last) {
+		miniSTL::make_heap(first, last,
+			miniSTL::less<typename miniSTL::iterator_traits<RandomAccessIterator>::value_type>());
 	}
 
 	/*
 	* push_heap
-	* Algorithm Complexity: O(N)
+	* Algorithm Complexity: O(logN)
 	*/
-	template <class RandomAccessIterator>
-	void push_heap(RandomAccessIterator first, RandomAccessIterator last) {
-		push_heap(first, last,
-			miniSTL::less<typename miniSTL::iterator_traits<RandomAccessIterator>::value_type>());
+	template <class RandomAccessIterator, class Compare, class HeapPolicy>
+	void push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp, HeapPolicy policy) {
+		if (last - first > 1)
+			Detail::heap_up(first, last - first - 1, comp, policy, Detail::heap_untracked());
 	}
 
 	template <class RandomAccessIterator, class Compare>
 	void push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
-		up(first, last, first, comp);
+		miniSTL::push_heap(first, last, comp, binary_heap_policy());
+	}
+
+	template <class RandomAccessIterator>
+	void push_heap(RandomAccessIterator first, RandomAccessIterator last) {
+		miniSTL::push_heap(first, last,
+			miniSTL::less<typename miniSTL::iterator_traits<RandomAccessIterator>::value_type>());
 	}
 
 	/*
 	* pop_heap
-	* Algorithm Complexity: O(N)
+	* Algorithm Complexity: O(logN)
 	*/
-	template <class RandomAccessIterator>
-	void pop_heap(RandomAccessIterator first, RandomAccessIterator last) {
-		pop_heap(first, last,
-			miniSTL::less<typename miniSTL::iterator_traits<RandomAccessIterator>::value_type>());
+	template <class RandomAccessIterator, class Compare, class HeapPolicy>
+	void pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp, HeapPolicy policy) {
+		const auto len = last - first;
+		if (len < 2)
+			return;
+		auto val = std::move(*(last - 1));
+		*(last - 1) = std::move(*first);
+		Detail::heap_fill_hole(first, decltype(len)(0), len - 1, val, comp, policy, Detail::heap_untracked());
 	}
 
 	template <class RandomAccessIterator, class Compare>
 	void pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
-		miniSTL::swap(*first, *(last - 1));
-		if (last - first > 2)
-			down(first, last - 1, first, comp);
+		miniSTL::pop_heap(first, last, comp, binary_heap_policy());
+	}
+
+	template <class RandomAccessIterator>
+	void pop_heap(RandomAccessIterator first, RandomAccessIterator last) {
+		miniSTL::pop_heap(first, last,
+			miniSTL::less<typename miniSTL::iterator_traits<RandomAccessIterator>::value_type>());
 	}
 
 	/*
 	* sort_heap
-	* Algorithm Complexity: O(N)
+	* Algorithm Complexity: O(NlogN)
 	*/
-	template <class RandomAccessIterator>
-	void sort_heap(RandomAccessIterator first, RandomAccessIterator last) {
-		return miniSTL::sort_heap(first, last,
-			miniSTL::less<typename miniSTL::iterator_traits<RandomAccessIterator>::value_type>());
+	template <class RandomAccessIterator, class Compare, class HeapPolicy>
+	void sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp, HeapPolicy policy) {
+		for (auto cur = last; cur - first > 1; --cur) {
+			miniSTL::pop_heap(first, cur, comp, policy);
+		}
 	}
+
 	template <class RandomAccessIterator, class Compare>
 	void sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
-		for (auto cur = last; cur != first; --cur) {
-			pop_heap(first, cur, comp);
-		}
+		miniSTL::sort_heap(first, last, comp, binary_heap_policy());
+	}
+
+	template <class RandomAccessIterator>
+	void sort_heap(RandomAccessIterator first, RandomAccessIterator last) {
+		miniSTL::sort_heap(first, last,
+			miniSTL::less<typename miniSTL::iterator_traits<RandomAccessIterator>::value_type>());
 	}
 	/*
 	 * accumulate
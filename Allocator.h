@@ -17,6 +17,9 @@ namespace miniSTL
 		typedef const T&	const_reference;
 		typedef size_t		size_type;
 		typedef ptrdiff_t	difference_type;
+
+		template<class U>
+		struct rebind { typedef allocator<U> other; };
 	public:
 		static T *allocate();
 		static T *allocate(size_t n);
@@ -66,6 +69,38 @@ namespace miniSTL
 			first->~T();
 		}
 	}
+
+	//takes every block straight from malloc, bypassing the pool of alloc, so it may be used
+	//from several threads at once, e.g. by containers that are each guarded by their own lock
+	template<class T>
+	class malloc_allocator {
+	public:
+		typedef T			value_type;
+		typedef T*			pointer;
+		typedef const T*	const_pointer;
+		typedef T&			reference;
+		typedef const T&	const_reference;
+		typedef size_t		size_type;
+		typedef ptrdiff_t	difference_type;
+
+		template<class U>
+		struct rebind { typedef malloc_allocator<U> other; };
+	public:
+		static T *allocate() { return allocate(1); }
+		static T *allocate(size_t n) {
+			if (n == 0) return 0;
+			void *p = malloc(sizeof(T) * n);
+			if (!p) throw std::bad_alloc();
+			return static_cast<T *>(p);
+		}
+		static void deallocate(T *ptr) { free(ptr); }
+		static void deallocate(T *ptr, size_t) { free(ptr); }
+
+		static void construct(T *ptr) { allocator<T>::construct(ptr); }
+		static void construct(T *ptr, const T& value) { allocator<T>::construct(ptr, value); }
+		static void destroy(T *ptr) { allocator<T>::destroy(ptr); }
+		static void destroy(T *first, T *last) { allocator<T>::destroy(first, last); }
+	};
 }
 
 #endif
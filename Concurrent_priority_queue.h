@@ -0,0 +1,174 @@
+#ifndef _CONCURRENT_PRIORITY_QUEUE_H_
+#define _CONCURRENT_PRIORITY_QUEUE_H_
+
+#include "Algorithm.h"
+#include "Allocator.h"
+#include "Functional.h"
+#include "Vector.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace miniSTL
+{
+	namespace Detail
+	{
+		//one heap behind its own lock, padded so that neighbouring heaps never share a cache line.
+		//size mirrors heap.size() for lock-free emptiness hints, it is only written under lock.
+		//heaps grow on many threads at once, so they allocate through malloc_allocator
+		template <class T>
+		struct cpq_shard {
+			typedef miniSTL::vector<T, miniSTL::malloc_allocator<T>> heap_type;
+
+			std::mutex lock;
+			heap_type heap;
+			std::atomic<size_t> size;
+			char pad[64];
+
+			cpq_shard() : size(0) {}
+		};
+
+		//holds the locks of every shard for its scope, taken in index order
+		template <class Shard>
+		class cpq_lock_all
+		{
+		private:
+			Shard* shards_;
+			size_t locked_;
+
+		public:
+			cpq_lock_all(Shard* shards, size_t count) : shards_(shards), locked_(0) {
+				try {
+					for (; locked_ != count; ++locked_)
+						shards_[locked_].lock.lock();
+				}
+				catch (...) {
+					unlock();
+					throw;
+				}
+			}
+			cpq_lock_all(const cpq_lock_all&) = delete;
+			cpq_lock_all& operator = (const cpq_lock_all&) = delete;
+			~cpq_lock_all() { unlock(); }
+
+		private:
+			void unlock() {
+				while (locked_ != 0)
+					shards_[--locked_].lock.unlock();
+			}
+		};
+
+		//xorshift64*, one state per thread, seeded from the thread id
+		inline uint64_t cpq_random() {
+			static thread_local uint64_t state = 0;
+			if (state == 0)
+				state = (static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1) * 0x9E3779B97F4A7C15ULL;
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 0x2545F4914F6CDD1DULL;
+		}
+
+		//the number of elements of the heap [head, head + len) below idx that order after val,
+		//a subtree is left as soon as its root does not, so the cost follows the count
+		template <class T, class Compare, class HeapPolicy>
+		size_t cpq_count_before(const T* head, size_t len, size_t idx, const T& val, Compare& comp, HeapPolicy policy) {
+			if (idx >= len || !comp(val, head[idx]))
+				return 0;
+			size_t n = 1;
+			const size_t cIdx = HeapPolicy::first_child(idx);
+			for (size_t c = cIdx; c != cIdx + HeapPolicy::arity && c < len; ++c)
+				n += cpq_count_before(head, len, c, val, comp, policy);
+			return n;
+		}
+	}
+	//end of Detail
+
+	//how far relaxed pops strayed from the true top: the rank error of a pop is the number of
+	//queued elements that ordered before the one it returned, 0 for an exact pop
+	struct rank_error_stats {
+		size_t samples;
+		size_t total;
+		size_t max;
+
+		double mean()const { return samples ? static_cast<double>(total) / samples : 0; }
+	};
+
+	/*
+	 * Concurrent_priority_queue
+	 * a MultiQueue: queue_count heaps, each behind its own lock, about twice as many as
+	 * there are threads. push adds to a random heap. a relaxed pop picks two random heaps,
+	 * compares their tops and pops the better one, so threads rarely meet on a lock and
+	 * each pop is close to, but not always, the global top. the expected rank error grows
+	 * with queue_count, not with the number of elements.
+	 * strict mode pops the exact top by locking every heap in turn, which is correct but
+	 * serializes all pops. it can be switched on and off while threads run.
+	 * heaps keep their elements in a vector driven by the heap algorithms of priority_queue,
+	 * HeapPolicy sets their arity. a relaxed try_pop returns false once it saw every heap empty,
+	 * one after another, so while other threads push that result is only a hint. a strict
+	 * try_pop returns false only after it found every heap empty at once.
+	 */
+	template <class T, class Compare = miniSTL::less<T>, class HeapPolicy = miniSTL::binary_heap_policy>
+	class Concurrent_priority_queue
+	{
+	public:
+		typedef T value_type;
+		typedef size_t size_type;
+		typedef Compare value_compare;
+		typedef HeapPolicy heap_policy;
+
+	private:
+		typedef Detail::cpq_shard<T> shard;
+		typedef miniSTL::allocator<shard> shardAllocator;
+		typedef std::unique_lock<std::mutex> lock_type;
+		typedef Detail::cpq_lock_all<shard> lock_all;
+
+		shard* shards_;
+		size_type shard_count_;
+		Compare compare_;
+		std::atomic<bool> strict_;
+		std::atomic<size_type> sample_every_;
+		std::atomic<size_type> samples_;
+		std::atomic<size_type> rank_total_;
+		std::atomic<size_type> rank_max_;
+
+	public:
+		//queue_count 0 means two heaps per hardware thread
+		explicit Concurrent_priority_queue(size_type queue_count = 0, const Compare& comp = Compare());
+		Concurrent_priority_queue(const Concurrent_priority_queue&) = delete;
+		Concurrent_priority_queue& operator = (const Concurrent_priority_queue&) = delete;
+		~Concurrent_priority_queue();
+
+		size_type queue_count()const { return shard_count_; }
+
+		//sum of the heap sizes, only a snapshot while other threads run
+		size_type size()const;
+		bool empty()const { return size() == 0; }
+
+		void push(const value_type& val);
+		//moves an element, the top one in strict mode, into result, false when the queue is empty.
+		//a relaxed false may miss elements pushed meanwhile, a polling caller simply tries again
+		bool try_pop(value_type& result);
+
+		bool strict()const { return strict_.load(); }
+		void set_strict(bool strict) { strict_.store(strict); }
+
+		//measures the rank error of about one pop in every, 0 stops. a measured pop locks every
+		//heap to count, so this is for judging queue_count, not for production runs
+		void sample_rank_error(size_type every) { sample_every_.store(every); }
+		rank_error_stats rank_error()const;
+		void reset_rank_error();
+
+	private:
+		size_type randomShard()const { return static_cast<size_type>(Detail::cpq_random() % shard_count_); }
+		void popFrom(shard& s, value_type& result);
+		bool tryPopRelaxed(value_type& result);
+		bool popStrict(value_type& result);
+		void measure(const value_type& popped);
+	};
+}
+
+#include "Detail\Concurrent_priority_queue.impl.h"
+#endif
@@ -0,0 +1,101 @@
+#ifndef _CONCURRENT_UNORDERED_SET_H_
+#define _CONCURRENT_UNORDERED_SET_H_
+
+#include "Allocator.h"
+#include "Unordered_set.h"
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+namespace miniSTL
+{
+	namespace Detail
+	{
+		//one independently locked Unordered_set, padded so that neighbouring shards never share a cache line
+		template <class Set>
+		struct cus_shard {
+			mutable std::shared_timed_mutex lock;
+			Set set;
+			char pad[64];
+
+			cus_shard(typename Set::size_type bucket_count, const typename Set::haser& hash, const typename Set::equal_key& equal)
+				: set(bucket_count, hash, equal) {}
+		};
+	}
+
+	/*
+	 * Concurrent_unordered_set
+	 * a power of two number of Unordered_sets, each behind its own reader-writer lock.
+	 * a key is hashed once, the high bits of the mixed hash pick the shard and the full hash
+	 * is handed on to the shard, so readers only meet other threads on the lock of the shard
+	 * they probe and a writer blocks one shard, never the whole set.
+	 * results are returned by value, no iterator or reference outlives the lock guarding it.
+	 * shards allocate through malloc_allocator, the pool of alloc is not shared between threads.
+	 * shards never rehash incrementally, a lookup under a shared lock must not move nodes.
+	 */
+	template <class Key, class Hash = std::hash<Key>, class EqualKey = miniSTL::equal_to<Key>,
+	class Policy = prime_bucket_policy>
+	class Concurrent_unordered_set
+	{
+	public:
+		typedef Unordered_set<Key, Hash, EqualKey, miniSTL::malloc_allocator<Key>, Policy> shard_type;
+		typedef Key key_type;
+		typedef Key value_type;
+		typedef size_t size_type;
+		typedef Hash haser;
+		typedef EqualKey equal_key;
+
+	private:
+		typedef Detail::cus_shard<shard_type> shard;
+		typedef miniSTL::allocator<shard> shardAllocator;
+		typedef std::shared_lock<std::shared_timed_mutex> read_lock;
+		typedef std::unique_lock<std::shared_timed_mutex> write_lock;
+
+		shard* shards_;
+		size_type shard_count_;
+		int shard_bits_;
+		haser hash_;
+
+	public:
+		//shard_count is rounded up to a power of two, bucket_count is shared out among the shards
+		explicit Concurrent_unordered_set(size_type shard_count = 16, size_type bucket_count = 0,
+			const haser& hash = haser(), const equal_key& equal = equal_key());
+		Concurrent_unordered_set(const Concurrent_unordered_set&) = delete;
+		Concurrent_unordered_set& operator = (const Concurrent_unordered_set&) = delete;
+		~Concurrent_unordered_set();
+
+		size_type shard_count()const { return shard_count_; }
+		size_type shard_of(const key_type& key)const { return shard_index(hash_(key)); }
+
+		//sum of the shard sizes, each read under its own lock, only a snapshot while writers run
+		size_type size()const;
+		bool empty()const { return size() == 0; }
+
+		bool insert(const value_type& val);
+		//copies the stored key equal to key into result
+		bool find(const key_type& key, value_type& result)const;
+		bool contains(const key_type& key)const;
+		size_type count(const key_type& key)const { return contains(key) ? 1 : 0; }
+		size_type erase(const key_type& key);
+		void clear();
+
+		//grows shard i to at least n buckets, the other shards stay available meanwhile
+		void rehash_shard(size_type i, size_type n);
+		//grows the shards one after another, each to its share of n buckets
+		void rehash(size_type n);
+
+		//calls f(shard_type&) on every shard in turn, holding that shard's write lock.
+		//f may change the shard, incremental rehash is switched off again once f returns
+		template <class Func>
+		void for_each_shard(Func f);
+
+		haser hash_function()const { return hash_; }
+
+	private:
+		size_type shard_index(size_type hash)const;
+	};
+}
+
+#include "Detail\Concurrent_unordered_set.impl.h"
+#endif
@@ -0,0 +1,176 @@
+#ifndef _CONCURRENT_PRIORITY_QUEUE_IMPL_H_
+#define _CONCURRENT_PRIORITY_QUEUE_IMPL_H_
+
+namespace miniSTL
+{
+	template<class T, class Compare, class HeapPolicy>
+	Concurrent_priority_queue<T, Compare, HeapPolicy>::Concurrent_priority_queue(size_type queue_count, const Compare& comp)
+		: compare_(comp), strict_(false), sample_every_(0), samples_(0), rank_total_(0), rank_max_(0) {
+		if (queue_count == 0)
+			queue_count = 2 * static_cast<size_type>(std::thread::hardware_concurrency());
+		shard_count_ = queue_count < 2 ? 2 : queue_count;
+		shards_ = shardAllocator::allocate(shard_count_);
+		for (size_type i = 0; i != shard_count_; ++i)
+			new(shards_ + i) shard();
+	}
+
+	template<class T, class Compare, class HeapPolicy>
+	Concurrent_priority_queue<T, Compare, HeapPolicy>::~Concurrent_priority_queue() {
+		shardAllocator::destroy(shards_, shards_ + shard_count_);
+		shardAllocator::deallocate(shards_, shard_count_);
+	}
+
+	template<class T, class Compare, class HeapPolicy>
+	typename Concurrent_priority_queue<T, Compare, HeapPolicy>::size_type
+		Concurrent_priority_queue<T, Compare, HeapPolicy>::size()const {
+		size_type n = 0;
+		for (size_type i = 0; i != shard_count_; ++i)
+			n += shards_[i].size.load(std::memory_order_relaxed);
+		return n;
+	}
+
+	//a busy heap is skipped for another random one, only after a full round of misses
+	//does the push wait for a lock
+	template<class T, class Compare, class HeapPolicy>
+	void Concurrent_priority_queue<T, Compare, HeapPolicy>::push(const value_type& val) {
+		lock_type guard;
+		shard* s = nullptr;
+		for (size_type attempt = 0; attempt != shard_count_ && !guard.owns_lock(); ++attempt) {
+			s = shards_ + randomShard();
+			guard = lock_type(s->lock, std::try_to_lock);
+		}
+		if (!guard.owns_lock())
+			guard = lock_type(s->lock);
+		s->heap.push_back(val);
+		miniSTL::push_heap(s->heap.begin(), s->heap.end(), compare_, HeapPolicy());
+		s->size.store(static_cast<size_t>(s->heap.size()), std::memory_order_relaxed);
+	}
+
+	template<class T, class Compare, class HeapPolicy>
+	bool Concurrent_priority_queue<T, Compare, HeapPolicy>::try_pop(value_type& result) {
+		const bool popped = strict_.load(std::memory_order_relaxed) ? popStrict(result) : tryPopRelaxed(result);
+		if (popped) {
+			const size_type every = sample_every_.load(std::memory_order_relaxed);
+			if (every != 0 && Detail::cpq_random() % every == 0)
+				measure(result);
+		}
+		return popped;
+	}
+
+	template<class T, class Compare, class HeapPolicy>
+	rank_error_stats Concurrent_priority_queue<T, Compare, HeapPolicy>::rank_error()const {
+		rank_error_stats stats = { samples_.load(), rank_total_.load(), rank_max_.load() };
+		return stats;
+	}
+
+	template<class T, class Compare, class HeapPolicy>
+	void Concurrent_priority_queue<T, Compare, HeapPolicy>::reset_rank_error() {
+		samples_.store(0);
+		rank_total_.store(0);
+		rank_max_.store(0);
+	}
+
+	//the caller holds s.lock and has seen s non-empty
+	template<class T, class Compare, class HeapPolicy>
+	void Concurrent_priority_queue<T, Compare, HeapPolicy>::popFrom(shard& s, value_type& result) {
+		miniSTL::pop_heap(s.heap.begin(), s.heap.end(), compare_, HeapPolicy());
+		result = std::move(s.heap.back());
+		s.heap.pop_back();
+		s.size.store(static_cast<size_t>(s.heap.size()), std::memory_order_relaxed);
+	}
+
+	//two random heaps, the sizes only steer which ones are worth locking. locks are only
+	//tried here, so a relaxed pop never waits and never deadlocks with a strict one.
+	//after a full round of misses the queue is nearly empty or heavily contended, and the
+	//heaps whose size is not 0 are locked one at a time, never all together
+	template<class T, class Compare, class HeapPolicy>
+	bool Concurrent_priority_queue<T, Compare, HeapPolicy>::tryPopRelaxed(value_type& result) {
+		for (size_type attempt = 0; attempt != 2 * shard_count_; ++attempt) {
+			const size_type i = randomShard();
+			size_type j = static_cast<size_type>(Detail::cpq_random() % (shard_count_ - 1));
+			j += j >= i ? 1 : 0;
+			shard* a = shards_ + i;
+			shard* b = shards_ + j;
+			const bool aFull = a->size.load(std::memory_order_relaxed) != 0;
+			const bool bFull = b->size.load(std::memory_order_relaxed) != 0;
+			if (!aFull && !bFull)
+				continue;
+			if (!aFull || !bFull) {
+				shard* s = aFull ? a : b;
+				lock_type guard(s->lock, std::try_to_lock);
+				if (!guard.owns_lock() || s->heap.empty())
+					continue;
+				popFrom(*s, result);
+				return true;
+			}
+
+			lock_type guardA(a->lock, std::try_to_lock);
+			if (!guardA.owns_lock())
+				continue;
+			lock_type guardB(b->lock, std::try_to_lock);
+			if (!guardB.owns_lock())
+				continue;
+			if (a->heap.empty() && b->heap.empty())
+				continue;
+			if (b->heap.empty() || (!a->heap.empty() && !compare_(a->heap[0], b->heap[0]))) {
+				guardB.unlock();
+				popFrom(*a, result);
+			}
+			else {
+				guardA.unlock();
+				popFrom(*b, result);
+			}
+			return true;
+		}
+
+		const size_type start = randomShard();
+		for (size_type k = 0; k != shard_count_; ++k) {
+			shard& s = shards_[(start + k) % shard_count_];
+			if (s.size.load(std::memory_order_relaxed) == 0)
+				continue;
+			lock_type guard(s.lock);
+			if (s.heap.empty())
+				continue;
+			popFrom(s, result);
+			return true;
+		}
+		return false;
+	}
+
+	//every heap locked in index order, the only order any thread ever waits in
+	template<class T, class Compare, class HeapPolicy>
+	bool Concurrent_priority_queue<T, Compare, HeapPolicy>::popStrict(value_type& result) {
+		lock_all guard(shards_, shard_count_);
+		shard* best = nullptr;
+		for (size_type i = 0; i != shard_count_; ++i) {
+			shard& s = shards_[i];
+			if (!s.heap.empty() && (!best || compare_(best->heap[0], s.heap[0])))
+				best = &s;
+		}
+		if (!best)
+			return false;
+		popFrom(*best, result);
+		return true;
+	}
+
+	//counted right after the pop, an element pushed in between counts against it too
+	template<class T, class Compare, class HeapPolicy>
+	void Concurrent_priority_queue<T, Compare, HeapPolicy>::measure(const value_type& popped) {
+		size_type rank = 0;
+		{
+			lock_all guard(shards_, shard_count_);
+			for (size_type i = 0; i != shard_count_; ++i) {
+				const typename shard::heap_type& heap = shards_[i].heap;
+				rank += Detail::cpq_count_before(heap.begin(), static_cast<size_t>(heap.size()), 0, popped, compare_, HeapPolicy());
+			}
+		}
+
+		++samples_;
+		rank_total_ += rank;
+		size_type seen = rank_max_.load();
+		while (rank > seen && !rank_max_.compare_exchange_weak(seen, rank))
+			;
+	}
+}
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef _CONCURRENT_UNORDERED_SET_IMPL_H_
+#define _CONCURRENT_UNORDERED_SET_IMPL_H_
+
+namespace miniSTL
+{
+	template<class Key, class Hash, class EqualKey, class Policy>
+	Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::Concurrent_unordered_set(size_type shard_count, size_type bucket_count,
+		const haser& hash, const equal_key& equal) : hash_(hash) {
+		shard_count_ = 1;
+		shard_bits_ = 0;
+		while (shard_count_ < shard_count) {
+			shard_count_ <<= 1;
+			++shard_bits_;
+		}
+		shards_ = shardAllocator::allocate(shard_count_);
+		for (size_type i = 0; i != shard_count_; ++i)
+			new(shards_ + i) shard(bucket_count / shard_count_, hash, equal);
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::~Concurrent_unordered_set() {
+		shardAllocator::destroy(shards_, shards_ + shard_count_);
+		shardAllocator::deallocate(shards_, shard_count_);
+	}
+
+	//the shard index comes from the top bits, the shard's own bucket index from the whole hash
+	template<class Key, class Hash, class EqualKey, class Policy>
+	typename Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::size_type
+		Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::shard_index(size_type hash)const {
+		uint64_t x = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+		return shard_bits_ ? static_cast<size_type>(x >> (64 - shard_bits_)) : 0;
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	typename Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::size_type
+		Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::size()const {
+		size_type n = 0;
+		for (size_type i = 0; i != shard_count_; ++i) {
+			read_lock guard(shards_[i].lock);
+			n += shards_[i].set.size();
+		}
+		return n;
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	bool Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::insert(const value_type& val) {
+		size_type hash = hash_(val);
+		shard& s = shards_[shard_index(hash)];
+		write_lock guard(s.lock);
+		return s.set.insert(val, hash).second;
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	bool Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::find(const key_type& key, value_type& result)const {
+		size_type hash = hash_(key);
+		shard& s = shards_[shard_index(hash)];
+		read_lock guard(s.lock);
+		auto it = s.set.find(key, hash);
+		if (it == s.set.end())
+			return false;
+		result = *it;
+		return true;
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	bool Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::contains(const key_type& key)const {
+		size_type hash = hash_(key);
+		shard& s = shards_[shard_index(hash)];
+		read_lock guard(s.lock);
+		return s.set.count(key, hash) != 0;
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	typename Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::size_type
+		Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::erase(const key_type& key) {
+		size_type hash = hash_(key);
+		shard& s = shards_[shard_index(hash)];
+		write_lock guard(s.lock);
+		auto it = s.set.find(key, hash);
+		if (it == s.set.end())
+			return 0;
+		s.set.erase(it);
+		return 1;
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	void Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::clear() {
+		for (size_type i = 0; i != shard_count_; ++i) {
+			write_lock guard(shards_[i].lock);
+			shards_[i].set.clear();
+		}
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	void Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::rehash_shard(size_type i, size_type n) {
+		write_lock guard(shards_[i].lock);
+		shards_[i].set.rehash(n);
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	void Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::rehash(size_type n) {
+		for (size_type i = 0; i != shard_count_; ++i)
+			rehash_shard(i, n / shard_count_);
+	}
+
+	//switching incremental rehash off again also finishes any migration f started,
+	//before readers may look at the shard
+	template<class Key, class Hash, class EqualKey, class Policy>
+	template<class Func>
+	void Concurrent_unordered_set<Key, Hash, EqualKey, Policy>::for_each_shard(Func f) {
+		for (size_type i = 0; i != shard_count_; ++i) {
+			write_lock guard(shards_[i].lock);
+			f(shards_[i].set);
+			shards_[i].set.incremental_rehash(false);
+		}
+	}
+}
+
+#endif
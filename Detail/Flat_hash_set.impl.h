@@ -0,0 +1,336 @@
+#ifndef _FLAT_HASH_SET_IMPL_H_
+#define _FLAT_HASH_SET_IMPL_H_
+
+namespace miniSTL
+{
+	//smallest 2^k - 1 that holds n slots, never below one full group
+	template <class Key, class Hash, class EqualKey>
+	typename flat_hash_set<Key, Hash, EqualKey>::size_type
+		flat_hash_set<Key, Hash, EqualKey>::normalize_capacity(size_type n) {
+		size_type capacity = 15;
+		while (capacity < n)
+			capacity = capacity * 2 + 1;
+		return capacity;
+	}
+
+	//the first width - 1 control bytes are mirrored after the sentinel, so a group load never wraps
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::set_ctrl(size_type i, ctrl_type h) {
+		const size_type cloned = group_type::width - 1;
+		ctrl_[i] = h;
+		ctrl_[((i - cloned) & capacity_) + cloned] = h;
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::initialize(size_type capacity) {
+		ctrl_ = ctrlAllocator::allocate(capacity + group_type::width);
+		std::memset(ctrl_, static_cast<unsigned char>(Detail::fhs_empty), capacity + group_type::width);
+		ctrl_[capacity] = Detail::fhs_sentinel;
+		slots_ = slotAllocator::allocate(capacity);
+		capacity_ = capacity;
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::destroy_slots() {
+		for (size_type i = 0; i != capacity_; ++i) {
+			if (ctrl_[i] >= 0)
+				slotAllocator::destroy(slots_ + i);
+		}
+		if (capacity_) {
+			ctrlAllocator::deallocate(ctrl_, capacity_ + group_type::width);
+			slotAllocator::deallocate(slots_, capacity_);
+		}
+	}
+
+	//rebuild into a fresh table, moving every key to the slot its hash now selects
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::resize(size_type new_capacity) {
+		ctrl_type* old_ctrl = ctrl_;
+		Key* old_slots = slots_;
+		size_type old_capacity = capacity_;
+
+		initialize(new_capacity);
+		for (size_type i = 0; i != old_capacity; ++i) {
+			if (old_ctrl[i] >= 0) {
+				size_type hash = hash_of(old_slots[i]);
+				size_type j = find_insert_slot(hash);
+				set_ctrl(j, h2(hash));
+				new(slots_ + j) Key(std::move(old_slots[i]));
+				slotAllocator::destroy(old_slots + i);
+			}
+		}
+		reset_growth_left();
+
+		if (old_capacity) {
+			ctrlAllocator::deallocate(old_ctrl, old_capacity + group_type::width);
+			slotAllocator::deallocate(old_slots, old_capacity);
+		}
+	}
+
+	//out of room: a table mostly full of tombstones is rebuilt in place, otherwise it doubles
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::grow_or_purge() {
+		if (capacity_ == 0)
+			resize(normalize_capacity(0));
+		else if (size_ <= capacity_to_growth(capacity_) / 2)
+			resize(capacity_);
+		else
+			resize(capacity_ * 2 + 1);
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	typename flat_hash_set<Key, Hash, EqualKey>::size_type
+		flat_hash_set<Key, Hash, EqualKey>::find_index(const key_type& key, size_type hash) const {
+		const size_type mask = capacity_;
+		size_type pos = h1(hash) & mask;
+		size_type step = 0;
+		while (true) {
+			group_type g(ctrl_ + pos);
+			for (auto m = g.match(h2(hash)); m; m.next()) {
+				size_type i = (pos + m.lowest()) & mask;
+				if (equal_(slots_[i], key))
+					return i;
+			}
+			if (g.match_empty())
+				return capacity_;
+			step += group_type::width;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	typename flat_hash_set<Key, Hash, EqualKey>::size_type
+		flat_hash_set<Key, Hash, EqualKey>::find_insert_slot(size_type hash) const {
+		const size_type mask = capacity_;
+		size_type pos = h1(hash) & mask;
+		size_type step = 0;
+		while (true) {
+			auto m = group_type(ctrl_ + pos).match_empty_or_deleted();
+			if (m)
+				return (pos + m.lowest()) & mask;
+			step += group_type::width;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	//pick a slot for a key known to be absent, the table grows first if it needs to
+	template <class Key, class Hash, class EqualKey>
+	typename flat_hash_set<Key, Hash, EqualKey>::size_type
+		flat_hash_set<Key, Hash, EqualKey>::prepare_insert(size_type hash) {
+		size_type i = find_insert_slot(hash);
+		if (growth_left_ == 0 && ctrl_[i] != Detail::fhs_deleted) {
+			grow_or_purge();
+			i = find_insert_slot(hash);
+		}
+		return i;
+	}
+
+	//the key now lives in slot i, reusing a tombstone costs no growth
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::commit_insert(size_type i, size_type hash) {
+		if (ctrl_[i] == Detail::fhs_empty)
+			--growth_left_;
+		++size_;
+		set_ctrl(i, h2(hash));
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	flat_hash_set<Key, Hash, EqualKey>::flat_hash_set(size_type bucket_count, const hasher& hash, const key_equal& equal)
+		: ctrl_(Detail::fhs_empty_group()), slots_(nullptr), capacity_(0), size_(0), growth_left_(0),
+		hash_(hash), equal_(equal) {
+		if (bucket_count)
+			rehash(bucket_count);
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	template <class InputIterator>
+	flat_hash_set<Key, Hash, EqualKey>::flat_hash_set(InputIterator first, InputIterator last)
+		: ctrl_(Detail::fhs_empty_group()), slots_(nullptr), capacity_(0), size_(0), growth_left_(0) {
+		insert(first, last);
+	}
+
+	//same capacity and same hasher, so the control bytes and slot positions are copied as they are
+	template <class Key, class Hash, class EqualKey>
+	flat_hash_set<Key, Hash, EqualKey>::flat_hash_set(const flat_hash_set& s)
+		: ctrl_(Detail::fhs_empty_group()), slots_(nullptr), capacity_(0), size_(s.size_), growth_left_(0),
+		hash_(s.hash_), equal_(s.equal_) {
+		if (s.capacity_ == 0)
+			return;
+
+		initialize(s.capacity_);
+		std::memcpy(ctrl_, s.ctrl_, capacity_ + group_type::width);
+		for (size_type i = 0; i != capacity_; ++i) {
+			if (ctrl_[i] >= 0)
+				new(slots_ + i) Key(s.slots_[i]);
+		}
+		growth_left_ = s.growth_left_;
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	flat_hash_set<Key, Hash, EqualKey>::flat_hash_set(flat_hash_set&& s)
+		: ctrl_(Detail::fhs_empty_group()), slots_(nullptr), capacity_(0), size_(0), growth_left_(0),
+		hash_(s.hash_), equal_(s.equal_) {
+		swap(s);
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	flat_hash_set<Key, Hash, EqualKey>& flat_hash_set<Key, Hash, EqualKey>::operator = (const flat_hash_set& s) {
+		if (this != &s) {
+			flat_hash_set temp(s);
+			swap(temp);
+		}
+		return *this;
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	flat_hash_set<Key, Hash, EqualKey>& flat_hash_set<Key, Hash, EqualKey>::operator = (flat_hash_set&& s) {
+		if (this != &s) {
+			flat_hash_set temp(std::move(s));
+			swap(temp);
+		}
+		return *this;
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	flat_hash_set<Key, Hash, EqualKey>::~flat_hash_set() {
+		destroy_slots();
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::rehash(size_type n) {
+		size_type needed = size_ ? growth_to_capacity(size_) : 0;
+		if (n > needed)
+			needed = n;
+		if (needed == 0)
+			return;
+
+		size_type capacity = normalize_capacity(needed);
+		if (capacity > capacity_)
+			resize(capacity);
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::reserve(size_type n) {
+		if (n)
+			rehash(growth_to_capacity(n));
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	typename flat_hash_set<Key, Hash, EqualKey>::iterator flat_hash_set<Key, Hash, EqualKey>::begin() const {
+		iterator it(ctrl_, slots_);
+		it.skip_empty_or_deleted();
+		return it;
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	typename flat_hash_set<Key, Hash, EqualKey>::iterator
+		flat_hash_set<Key, Hash, EqualKey>::find(const key_type& key) const {
+		return iterator_at(find_index(key, hash_of(key)));
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	template <class V>
+	miniSTL::pair<typename flat_hash_set<Key, Hash, EqualKey>::iterator, bool>
+		flat_hash_set<Key, Hash, EqualKey>::insert_aux(V&& val) {
+		size_type hash = hash_of(val);
+		size_type i = find_index(val, hash);
+		if (i != capacity_)
+			return miniSTL::pair<iterator, bool>(iterator_at(i), false);
+
+		//the slot is only marked full once the key is built, a throwing constructor leaves it as it was
+		i = prepare_insert(hash);
+		new(slots_ + i) Key(std::forward<V>(val));
+		commit_insert(i, hash);
+		return miniSTL::pair<iterator, bool>(iterator_at(i), true);
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	miniSTL::pair<typename flat_hash_set<Key, Hash, EqualKey>::iterator, bool>
+		flat_hash_set<Key, Hash, EqualKey>::insert(const value_type& val) {
+		return insert_aux(val);
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	miniSTL::pair<typename flat_hash_set<Key, Hash, EqualKey>::iterator, bool>
+		flat_hash_set<Key, Hash, EqualKey>::insert(value_type&& val) {
+		return insert_aux(std::move(val));
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	template <class InputIterator>
+	void flat_hash_set<Key, Hash, EqualKey>::insert(InputIterator first, InputIterator last) {
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	/*
+	 * a slot can go straight back to empty when no probe could have run past it:
+	 * that holds if the run of non-empty bytes around it is shorter than a group,
+	 * because every group load covering the slot then already saw an empty and stopped
+	 */
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::erase_at(size_type i) {
+		slotAllocator::destroy(slots_ + i);
+		--size_;
+
+		size_type before = (i - group_type::width) & capacity_;
+		auto empty_after = group_type(ctrl_ + i).match_empty();
+		auto empty_before = group_type(ctrl_ + before).match_empty();
+		bool was_never_full = empty_before && empty_after &&
+			empty_after.trailing_zeros() + empty_before.leading_zeros() < group_type::width;
+
+		set_ctrl(i, was_never_full ? Detail::fhs_empty : Detail::fhs_deleted);
+		if (was_never_full)
+			++growth_left_;
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	typename flat_hash_set<Key, Hash, EqualKey>::iterator
+		flat_hash_set<Key, Hash, EqualKey>::erase(iterator position) {
+		erase_at(position.ctrl_ - ctrl_);
+		return ++position;
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	typename flat_hash_set<Key, Hash, EqualKey>::size_type
+		flat_hash_set<Key, Hash, EqualKey>::erase(const key_type& key) {
+		size_type i = find_index(key, hash_of(key));
+		if (i == capacity_)
+			return 0;
+		erase_at(i);
+		return 1;
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::clear() {
+		if (capacity_ == 0)
+			return;
+
+		for (size_type i = 0; i != capacity_; ++i) {
+			if (ctrl_[i] >= 0)
+				slotAllocator::destroy(slots_ + i);
+		}
+		std::memset(ctrl_, static_cast<unsigned char>(Detail::fhs_empty), capacity_ + group_type::width);
+		ctrl_[capacity_] = Detail::fhs_sentinel;
+		size_ = 0;
+		reset_growth_left();
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	void flat_hash_set<Key, Hash, EqualKey>::swap(flat_hash_set& s) {
+		miniSTL::swap(ctrl_, s.ctrl_);
+		miniSTL::swap(slots_, s.slots_);
+		miniSTL::swap(capacity_, s.capacity_);
+		miniSTL::swap(size_, s.size_);
+		miniSTL::swap(growth_left_, s.growth_left_);
+		miniSTL::swap(hash_, s.hash_);
+		miniSTL::swap(equal_, s.equal_);
+	}
+
+	template <class Key, class Hash, class EqualKey>
+	void swap(flat_hash_set<Key, Hash, EqualKey>& lhs, flat_hash_set<Key, Hash, EqualKey>& rhs) {
+		lhs.swap(rhs);
+	}
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef _INDEXED_PRIORITY_QUEUE_IMPL_H_
+#define _INDEXED_PRIORITY_QUEUE_IMPL_H_
+
+namespace miniSTL
+{
+	//freed slots are reused first, the generation they carry tells old handles apart
+	template <class T, class Compare, class HeapPolicy>
+	typename indexed_priority_queue<T, Compare, HeapPolicy>::handle_type
+		indexed_priority_queue<T, Compare, HeapPolicy>::push(const value_type& val) {
+		size_type slot;
+		if (!free_.empty()) {
+			slot = free_.back();
+			free_.pop_back();
+		}
+		else {
+			slot = static_cast<size_type>(slots_.size());
+			slot_info info = { npos, 0 };
+			slots_.push_back(info);
+		}
+		const size_type pos = static_cast<size_type>(heap_.size());
+		entry e = { val, slot };
+		heap_.push_back(e);
+		slots_[slot].pos = pos;
+		Detail::heap_up(heap_.begin(), pos, entryCompare(), HeapPolicy(), tracker());
+		handle_type h = { slot, slots_[slot].generation };
+		return h;
+	}
+
+	template <class T, class Compare, class HeapPolicy>
+	void indexed_priority_queue<T, Compare, HeapPolicy>::update(handle_type h, const value_type& val) {
+		const size_type pos = slots_[h.slot].pos;
+		heap_[pos].value = val;
+		resift(pos);
+	}
+
+	template <class T, class Compare, class HeapPolicy>
+	void indexed_priority_queue<T, Compare, HeapPolicy>::reserve(size_type n) {
+		heap_.reserve(n);
+		slots_.reserve(n);
+		free_.reserve(n);
+	}
+
+	//the slots are kept with a new generation, so no old handle is contained afterwards
+	template <class T, class Compare, class HeapPolicy>
+	void indexed_priority_queue<T, Compare, HeapPolicy>::clear() {
+		heap_.clear();
+		free_.clear();
+		for (size_type slot = static_cast<size_type>(slots_.size()); slot != 0; --slot) {
+			slots_[slot - 1].pos = npos;
+			++slots_[slot - 1].generation;
+			free_.push_back(slot - 1);
+		}
+	}
+
+	template <class T, class Compare, class HeapPolicy>
+	void indexed_priority_queue<T, Compare, HeapPolicy>::swap(indexed_priority_queue& x) {
+		heap_.swap(x.heap_);
+		slots_.swap(x.slots_);
+		free_.swap(x.free_);
+		miniSTL::swap(compare_, x.compare_);
+	}
+
+	template <class T, class Compare, class HeapPolicy>
+	typename indexed_priority_queue<T, Compare, HeapPolicy>::handle_type
+		indexed_priority_queue<T, Compare, HeapPolicy>::handleOf(size_type pos) const {
+		const size_type slot = heap_[pos].slot;
+		handle_type h = { slot, slots_[slot].generation };
+		return h;
+	}
+
+	//the last entry fills the hole, which sinks to a leaf first and lets it climb from there
+	template <class T, class Compare, class HeapPolicy>
+	void indexed_priority_queue<T, Compare, HeapPolicy>::eraseAt(size_type pos) {
+		slot_info& freed = slots_[heap_[pos].slot];
+		freed.pos = npos;
+		++freed.generation;
+		free_.push_back(heap_[pos].slot);
+
+		const size_type last = static_cast<size_type>(heap_.size()) - 1;
+		if (pos != last) {
+			entry val = std::move(heap_[last]);
+			Detail::heap_fill_hole(heap_.begin(), pos, last, val, entryCompare(), HeapPolicy(), tracker());
+		}
+		heap_.pop_back();
+	}
+
+	template <class T, class Compare, class HeapPolicy>
+	void indexed_priority_queue<T, Compare, HeapPolicy>::resift(size_type pos) {
+		if (Detail::heap_up(heap_.begin(), pos, entryCompare(), HeapPolicy(), tracker()) == pos)
+			Detail::heap_down(heap_.begin(), pos, static_cast<size_type>(heap_.size()), entryCompare(), HeapPolicy(), tracker());
+	}
+}
+
+#endif
@@ -0,0 +1,340 @@
+#ifndef _INTRUSIVE_LIST_IMPL_H_
+#define _INTRUSIVE_LIST_IMPL_H_
+
+namespace miniSTL
+{
+	namespace Detail
+	{
+		//disposer used when the caller keeps ownership of unlinked elements
+		struct ilist_null_disposer {
+			template <class T>
+			void operator()(T&) {}
+		};
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::init() {
+		header_.prev = header_.next = &header_;
+		size_ = 0;
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::linkBefore(node_base* position, node_base* p) {
+		p->next = position;
+		p->prev = position->prev;
+		position->prev->next = p;
+		position->prev = p;
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::unlink(node_base* p) {
+		p->prev->next = p->next;
+		p->next->prev = p->prev;
+		p->prev = p->next = nullptr;
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::fixHeader() {
+		if (size_ == 0) {
+			header_.prev = header_.next = &header_;
+		}
+		else {
+			header_.next->prev = &header_;
+			header_.prev->next = &header_;
+		}
+	}
+
+	//move [first, last) in front of position, sizes are left to the caller
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::transfer(node_base* position, node_base* first, node_base* last) {
+		if (position == last || first == last)
+			return;
+
+		node_base* tail = last->prev;
+		first->prev->next = last;
+		last->prev = first->prev;
+
+		first->prev = position->prev;
+		position->prev->next = first;
+		tail->next = position;
+		position->prev = tail;
+	}
+
+	template <class T, class Tag>
+	typename intrusive_list<T, Tag>::node_base* intrusive_list<T, Tag>::unlinkAll() {
+		if (header_.next == &header_)
+			return nullptr;
+
+		node_base* first = header_.next;
+		header_.prev->next = nullptr;
+		header_.prev = header_.next = &header_;
+		return first;
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::linkAll(node_base* first) {
+		if (!first)
+			return;
+
+		node_base* prev = &header_;
+		for (node_base* cur = first; cur; cur = cur->next) {
+			cur->prev = prev;
+			prev = cur;
+		}
+		prev->next = &header_;
+		header_.next = first;
+		header_.prev = prev;
+	}
+
+	template <class T, class Tag>
+	intrusive_list<T, Tag>::intrusive_list() {
+		init();
+	}
+
+	template <class T, class Tag>
+	intrusive_list<T, Tag>::intrusive_list(intrusive_list&& l) {
+		init();
+		swap(l);
+	}
+
+	template <class T, class Tag>
+	intrusive_list<T, Tag>& intrusive_list<T, Tag>::operator = (intrusive_list&& l) {
+		if (this != &l) {
+			clear();
+			swap(l);
+		}
+		return *this;
+	}
+
+	template <class T, class Tag>
+	intrusive_list<T, Tag>::~intrusive_list() {
+		clear();
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::push_front(reference val) {
+		linkBefore(header_.next, toNode(val));
+		++size_;
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::pop_front() {
+		unlink(header_.next);
+		--size_;
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::push_back(reference val) {
+		linkBefore(&header_, toNode(val));
+		++size_;
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::pop_back() {
+		unlink(header_.prev);
+		--size_;
+	}
+
+	template <class T, class Tag>
+	typename intrusive_list<T, Tag>::iterator intrusive_list<T, Tag>::iterator_to(reference val) {
+		return iterator(toNode(val));
+	}
+
+	template <class T, class Tag>
+	typename intrusive_list<T, Tag>::iterator intrusive_list<T, Tag>::insert(iterator position, reference val) {
+		node_base* p = toNode(val);
+		linkBefore(position.p, p);
+		++size_;
+		return iterator(p);
+	}
+
+	template <class T, class Tag>
+	template <class InputIterator>
+	void intrusive_list<T, Tag>::insert(iterator position, InputIterator first, InputIterator last) {
+		for (; first != last; ++first)
+			insert(position, *first);
+	}
+
+	template <class T, class Tag>
+	typename intrusive_list<T, Tag>::iterator intrusive_list<T, Tag>::erase(iterator position) {
+		return erase_and_dispose(position, Detail::ilist_null_disposer());
+	}
+
+	template <class T, class Tag>
+	typename intrusive_list<T, Tag>::iterator intrusive_list<T, Tag>::erase(iterator first, iterator last) {
+		while (first != last)
+			first = erase(first);
+		return last;
+	}
+
+	template <class T, class Tag>
+	template <class Disposer>
+	typename intrusive_list<T, Tag>::iterator intrusive_list<T, Tag>::erase_and_dispose(iterator position, Disposer disposer) {
+		node_base* p = position.p;
+		node_base* next = p->next;
+		unlink(p);
+		--size_;
+		disposer(toValue(p));
+		return iterator(next);
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::clear() {
+		clear_and_dispose(Detail::ilist_null_disposer());
+	}
+
+	template <class T, class Tag>
+	template <class Disposer>
+	void intrusive_list<T, Tag>::clear_and_dispose(Disposer disposer) {
+		node_base* cur = header_.next;
+		while (cur != &header_) {
+			node_base* next = cur->next;
+			cur->prev = cur->next = nullptr;
+			disposer(toValue(cur));
+			cur = next;
+		}
+		init();
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::swap(intrusive_list& l) {
+		miniSTL::swap(header_, l.header_);
+		miniSTL::swap(size_, l.size_);
+		fixHeader();
+		l.fixHeader();
+	}
+
+	template <class T, class Tag>
+	void swap(intrusive_list<T, Tag>& x, intrusive_list<T, Tag>& y) {
+		x.swap(y);
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::splice(iterator position, intrusive_list& l) {
+		if (this == &l || l.empty())
+			return;
+
+		transfer(position.p, l.header_.next, &l.header_);
+		size_ += l.size_;
+		l.size_ = 0;
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::splice(iterator position, intrusive_list& l, iterator i) {
+		auto next = i;
+		++next;
+		if (position == i || position == next)
+			return;
+
+		transfer(position.p, i.p, next.p);
+		++size_;
+		--l.size_;
+	}
+
+	//O(1) within one list, counting the range makes it O(n) between two lists
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::splice(iterator position, intrusive_list& l, iterator first, iterator last) {
+		if (first == last)
+			return;
+
+		if (this != &l) {
+			size_type n = 0;
+			for (auto it = first; it != last; ++it)
+				++n;
+			size_ += n;
+			l.size_ -= n;
+		}
+		transfer(position.p, first.p, last.p);
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::remove(const value_type& val) {
+		remove_if([&val](const value_type& x) { return x == val; });
+	}
+
+	template <class T, class Tag>
+	template <class Predicate>
+	void intrusive_list<T, Tag>::remove_if(Predicate pred) {
+		remove_and_dispose_if(pred, Detail::ilist_null_disposer());
+	}
+
+	template <class T, class Tag>
+	template <class Predicate, class Disposer>
+	void intrusive_list<T, Tag>::remove_and_dispose_if(Predicate pred, Disposer disposer) {
+		for (auto it = begin(); it != end();) {
+			if (pred(*it))
+				it = erase_and_dispose(it, disposer);
+			else
+				++it;
+		}
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::unique() {
+		unique(miniSTL::equal_to<T>());
+	}
+
+	template <class T, class Tag>
+	template <class BinaryPredicate>
+	void intrusive_list<T, Tag>::unique(BinaryPredicate binary_pred) {
+		unique_and_dispose(binary_pred, Detail::ilist_null_disposer());
+	}
+
+	template <class T, class Tag>
+	template <class BinaryPredicate, class Disposer>
+	void intrusive_list<T, Tag>::unique_and_dispose(BinaryPredicate binary_pred, Disposer disposer) {
+		if (size_ < 2)
+			return;
+
+		auto first = begin(), next = begin();
+		for (++next; next != end();) {
+			if (binary_pred(*first, *next))
+				next = erase_and_dispose(next, disposer);
+			else
+				first = next++;
+		}
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::merge(intrusive_list& l) {
+		merge(l, miniSTL::less<T>());
+	}
+
+	template <class T, class Tag>
+	template <class Compare>
+	void intrusive_list<T, Tag>::merge(intrusive_list& l, Compare comp) {
+		if (this == &l || l.empty())
+			return;
+
+		Detail::ilist_node_compare<T, Tag, Compare> nodeComp(comp);
+		linkAll(Detail::list_merge_chains(unlinkAll(), l.unlinkAll(), nodeComp));
+		size_ += l.size_;
+		l.size_ = 0;
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::sort() {
+		sort(miniSTL::less<T>());
+	}
+
+	template <class T, class Tag>
+	template <class Compare>
+	void intrusive_list<T, Tag>::sort(Compare comp) {
+		if (size_ < 2)
+			return;
+
+		Detail::ilist_node_compare<T, Tag, Compare> nodeComp(comp);
+		linkAll(Detail::list_sort_chain(unlinkAll(), nodeComp));
+	}
+
+	template <class T, class Tag>
+	void intrusive_list<T, Tag>::reverse() {
+		node_base* cur = &header_;
+		do {
+			miniSTL::swap(cur->prev, cur->next);
+			cur = cur->prev;
+		} while (cur != &header_);
+	}
+}
+
+#endif
@@ -6,75 +6,198 @@ namespace miniSTL
 	namespace Detail
 	{
 		template <class T>
-		listIterator<T>& listIterator<T>::operator++(){
-			p = p->next;
+		list_node_handle<T>& list_node_handle<T>::operator = (list_node_handle&& nh) {
+			if (this != &nh) {
+				this->~list_node_handle();
+				ptr_ = nh.ptr_;
+				nh.ptr_ = nullptr;
+			}
 			return *this;
 		}
 
 		template <class T>
-		listIterator<T> listIterator<T>::operator++(int) {
+		list_node_handle<T>::~list_node_handle() {
+			if (ptr_) {
+				allocator<Node<T>>::destroy(ptr_);
+				allocator<Node<T>>::deallocate(ptr_);
+			}
+		}
+
+		template <class T, class Ref, class Ptr>
+		listIterator<T, Ref, Ptr>& listIterator<T, Ref, Ptr>::operator++(){
+			p = p->next;
+			return *this;
+		}
+
+		template <class T, class Ref, class Ptr>
+		listIterator<T, Ref, Ptr> listIterator<T, Ref, Ptr>::operator++(int) {
 			auto res = *this;
 			++*this;
 			return res;
 		}
 
-		template <class T>
-		listIterator<T>& listIterator<T>::operator--() {
+		template <class T, class Ref, class Ptr>
+		listIterator<T, Ref, Ptr>& listIterator<T, Ref, Ptr>::operator--() {
 			p = p->prev;
 			return *this;
 		}
 
-		template <class T>
-		listIterator<T> listIterator<T>::operator--(int) {
+		template <class T, class Ref, class Ptr>
+		listIterator<T, Ref, Ptr> listIterator<T, Ref, Ptr>::operator--(int) {
 			auto res = *this;
 			--*this;
 			return res;
 		}
 
-		template <class T>
-		bool operator==(const listIterator<T>& lhs, const listIterator<T>& rhs) {
-			return lhs.p == rhs.p;
+		template <class NodePtr, class NodeCompare>
+		NodePtr list_merge_chains(NodePtr lhs, NodePtr rhs, NodeCompare& comp) {
+			NodePtr head = nullptr;
+			NodePtr* link = &head;
+			while (lhs && rhs) {
+				if (comp(rhs, lhs)) {
+					*link = rhs;
+					link = &rhs->next;
+					rhs = rhs->next;
+				}
+				else {
+					*link = lhs;
+					link = &lhs->next;
+					lhs = lhs->next;
+				}
+			}
+			*link = lhs ? lhs : rhs;
+			return head;
 		}
 
-		template <class T>
-		bool operator!=(const listIterator<T>& lhs, const listIterator<T>& rhs) {
-			return lhs.p != rhs.p;
+		//bin i holds a sorted run of 2^i nodes, a higher bin always holds earlier nodes
+		template <class NodePtr, class NodeCompare>
+		NodePtr list_sort_chain(NodePtr first, NodeCompare& comp) {
+			NodePtr bins[64] = {};
+			int fill = 0;
+			while (first) {
+				NodePtr carry = first;
+				first = first->next;
+				carry->next = nullptr;
+
+				int i = 0;
+				for (; i < fill && bins[i]; ++i) {
+					carry = list_merge_chains(bins[i], carry, comp);
+					bins[i] = nullptr;
+				}
+				if (i == 64)
+					--i;
+				bins[i] = carry;
+				if (i == fill)
+					++fill;
+			}
+
+			NodePtr res = nullptr;
+			for (int i = 0; i < fill; ++i)
+				res = list_merge_chains(bins[i], res, comp);
+			return res;
 		}
 	}
 
 	template <class T>
 	void list<T>::insert_aux(iterator position, size_type n, const T& val, std::true_type) {
-		for (int i = n; i != 0; --i)
+		for (size_type i = n; i != 0; --i)
 			position = insert(position, val);
 	}
 
 	template<class T>
 	template<class InputIterator>
 	void list<T>::insert_aux(iterator position, InputIterator first, InputIterator last, std::false_type) {
-		for (--last; first != last; --last) {
-			position = insert(position, *last);
-		}
-		insert(position, *last);
+		for (; first != last; ++first)
+			emplace(position, *first);
 	}
 
 	template<class T>
-	typename list<T>::nodeptr list<T>::newNode(const T& val = T()) {
+	template<class... Args>
+	typename list<T>::nodeptr list<T>::newNode(Args&&... args) {
 		nodeptr res = nodeAllocator::allocate();
-		nodeAllocator::construct(res, Detail::Node<T>(val, nullptr, nullptr));
+		new(res) Detail::Node<T>(nullptr, nullptr, std::forward<Args>(args)...);
 		return res;
 	}
 
 	template<class T>
 	void list<T>::deleteNode(nodeptr p) {
-		p->prev = p->next = nullptr;
 		nodeAllocator::destroy(p);
 		nodeAllocator::deallocate(p);
 	}
 
+	template<class T>
+	void list<T>::linkBefore(node_base* position, node_base* node) {
+		node->next = position;
+		node->prev = position->prev;
+		position->prev->next = node;
+		position->prev = node;
+	}
+
+	template<class T>
+	void list<T>::unlinkNode(node_base* node) {
+		node->prev->next = node->next;
+		node->next->prev = node->prev;
+	}
+
+	//move [first, last) in front of position, the range may come from any list
+	template<class T>
+	void list<T>::transfer(node_base* position, node_base* first, node_base* last) {
+		if (position == last || first == last)
+			return;
+
+		node_base* tailNode = last->prev;
+		first->prev->next = last;
+		last->prev = first->prev;
+
+		first->prev = position->prev;
+		position->prev->next = first;
+		tailNode->next = position;
+		position->prev = tailNode;
+	}
+
+	//the header lives inside the list object, so its neighbours must be pointed back at it after a swap
+	template<class T>
+	void list<T>::fixHeader() {
+		header_.next->prev = &header_;
+		header_.prev->next = &header_;
+	}
+
+	//detach every data node as a null-terminated chain, the list is left empty
+	template<class T>
+	typename list<T>::node_base* list<T>::unlinkAll() {
+		if (empty())
+			return nullptr;
+
+		node_base* first = header_.next;
+		header_.prev->next = nullptr;
+		header_.prev = header_.next = &header_;
+		return first;
+	}
+
+	//hang a null-terminated chain onto an empty list and rebuild the prev links
+	template<class T>
+	void list<T>::linkAll(node_base* first) {
+		if (!first)
+			return;
+
+		node_base* prev = &header_;
+		for (node_base* cur = first; cur; cur = cur->next) {
+			cur->prev = prev;
+			prev = cur;
+		}
+		prev->next = &header_;
+		header_.next = first;
+		header_.prev = prev;
+	}
+
+	template<class T>
+	void list<T>::init() {
+		header_.prev = header_.next = &header_;
+	}
+
 	template<class T>
 	void list<T>::ctorAux(size_type n, const value_type& val, std::true_type) {
-		head.p = newNode();//add a dummy node
-		tail.p = head.p;
+		init();
 		while (n--)
 			push_back(val);
 	}
@@ -82,8 +205,7 @@ namespace miniSTL
 	template<class T>
 	template <class InputIterator>
 	void list<T>::ctorAux(InputIterator first, InputIterator last, std::false_type) {
-		head.p = newNode();//add a dummy node
-		tail.p = head.p;
+		init();
 		for (; first != last; ++first)
 			push_back(*first);
 	}
@@ -91,20 +213,19 @@ namespace miniSTL
 	template<class T>
 	typename list<T>::size_type list<T>::size()const {
 		size_type length = 0;
-		for (auto h = head; h != tail; ++h)
+		for (auto node = header_.next; node != &header_; node = node->next)
 			++length;
 		return length;
 	}
 
 	template<class T>
 	list<T>::list() {
-		head.p = newNode();//add a dummy node
-		tail.p = head.p;
+		init();
 	}
 
 	template<class T>
 	list<T>::list(size_type n, const value_type& val = value_type()) {
-		ctorAux(n, val, std::is_integral<value_type>());
+		ctorAux(n, val, std::true_type());
 	}
 
 	template<class T>
@@ -115,92 +236,142 @@ namespace miniSTL
 
 	template<class T>
 	list<T>::list(const list& l) {
-		head.p = newNode();//add a dummy node
-		tail.p = head.p;
-		for (auto node = l.head.p; node != l.tail.p; node = node->next)
-			push_back(node->data);
+		init();
+		for (auto it = l.begin(); it != l.end(); ++it)
+			push_back(*it);
 	}
 
+	template<class T>
+	list<T>::list(list&& l) {
+		init();
+		swap(l);
+	}
+
+	//the nodes already owned by *this are reused, only the difference in length is allocated or freed
 	template<class T>
 	list<T>& list<T>::operator = (const list& l) {
+		if (this != &l)
+			assign(l.begin(), l.end());
+		return *this;
+	}
+
+	template<class T>
+	list<T>& list<T>::operator = (list&& l) {
 		if (this != &l) {
-			list(l).swap(*this);
+			clear();
+			swap(l);
 		}
 		return *this;
 	}
 
 	template<class T>
 	list<T>::~list() {
-		for (; head != tail;) {
-			auto temp = head++;
-			nodeAllocator::destroy(temp.p);
-			nodeAllocator::deallocate(temp.p);
+		clear();
+	}
+
+	template<class T>
+	void list<T>::assign(size_type n, const value_type& val) {
+		assign_aux(n, val, std::true_type());
+	}
+
+	template<class T>
+	template <class InputIterator>
+	void list<T>::assign(InputIterator first, InputIterator last) {
+		assign_aux(first, last, typename std::is_integral<InputIterator>::type());
+	}
+
+	template<class T>
+	void list<T>::assign_aux(size_type n, const value_type& val, std::true_type) {
+		auto it = begin();
+		for (; it != end() && n != 0; ++it, --n)
+			*it = val;
+
+		if (n == 0)
+			erase(it, end());
+		else {
+			for (; n != 0; --n)
+				emplace_back(val);
+		}
+	}
+
+	template<class T>
+	template <class InputIterator>
+	void list<T>::assign_aux(InputIterator first, InputIterator last, std::false_type) {
+		auto it = begin();
+		for (; it != end() && first != last; ++it, ++first)
+			*it = *first;
+
+		if (first == last)
+			erase(it, end());
+		else {
+			for (; first != last; ++first)
+				emplace_back(*first);
 		}
-		nodeAllocator::deallocate(tail.p);
+	}
+
+	template<class T>
+	template <class... Args>
+	void list<T>::emplace_front(Args&&... args) {
+		linkBefore(header_.next, newNode(std::forward<Args>(args)...));
+	}
+
+	template<class T>
+	template <class... Args>
+	void list<T>::emplace_back(Args&&... args) {
+		linkBefore(&header_, newNode(std::forward<Args>(args)...));
+	}
+
+	template<class T>
+	template <class... Args>
+	typename list<T>::iterator list<T>::emplace(iterator position, Args&&... args) {
+		auto node = newNode(std::forward<Args>(args)...);
+		linkBefore(position.p, node);
+		return iterator(node);
 	}
 
 	template<class T>
 	void list<T>::push_front(const value_type& val) {
-		auto node = newNode(val);
-		head.p->prev = node;
-		node->next = head.p;
-		head.p = node;
+		emplace_front(val);
+	}
+
+	template<class T>
+	void list<T>::push_front(value_type&& val) {
+		emplace_front(std::move(val));
 	}
 
 	template<class T>
 	void list<T>::pop_front() {
-		auto oldNode = head.p;
-		head.p = oldNode->next;
-		head.p->prev = nullptr;
-		deleteNode(oldNode);
+		erase(begin());
 	}
 
 	template<class T>
 	void list<T>::push_back(const value_type& val) {
-		auto node = newNode();
-		(tail.p)->data = val;
-		(tail.p)->next = node;
-		node->prev = tail.p;
-		tail.p = node;
+		emplace_back(val);
 	}
 
 	template<class T>
-	void list<T>::pop_back() {
-		auto newTail = tail.p->prev;
-		newTail->next = nullptr;
-		deleteNode(tail.p);
-		tail.p = newTail;
+	void list<T>::push_back(value_type&& val) {
+		emplace_back(std::move(val));
 	}
 
 	template<class T>
-	typename list<T>::iterator list<T>::insert(iterator position, const value_type& val)
-	{
-		if (position == begin())
-		{
-			push_front(val);
-			return begin();
-		}
-
-		else if (position == end())
-		{
-			auto ret = position;
-			push_back(val);
-			return ret;
-		}
+	void list<T>::pop_back() {
+		erase(iterator(header_.prev));
+	}
 
-		auto node = newNode(val);
-		auto prev = position.p->prev;
+	template<class T>
+	typename list<T>::iterator list<T>::insert(iterator position, const value_type& val) {
+		return emplace(position, val);
+	}
 
-		node->next = position.p;
-		node->prev = prev;
-		prev->next = node;
-		position.p->prev = node;
-		return iterator(node);
+	template<class T>
+	typename list<T>::iterator list<T>::insert(iterator position, value_type&& val) {
+		return emplace(position, std::move(val));
 	}
 
 	template<class T>
 	void list<T>::insert(iterator position, size_type n, const value_type& val) {
-		insert_aux(position, n, val, typename std::is_integral<InputIterator>::type());
+		insert_aux(position, n, val, std::true_type());
 	}
 
 	template<class T>
@@ -212,66 +383,77 @@ namespace miniSTL
 	template<class T>
 	typename list<T>::iterator list<T>::erase(iterator position)
 	{
-		if (position == head)
-		{
-			pop_front();
-			return head;
-		}
-		else
-		{
-			auto prev = position.p->prev;
-			prev->next = position.p->next;
-			position.p->next->prev = prev;
-			deleteNode(position.p);
-			return iterator(prev->next);
-		}
+		auto next = position.p->next;
+		unlinkNode(position.p);
+		deleteNode(static_cast<nodeptr>(position.p));
+		return iterator(next);
 	}
 
 	template <class T>
 	typename list<T>::iterator list<T>::erase(iterator first, iterator last)
 	{
-		typename list<T>::iterator res;
 		for (; first != last;)
-		{
-			auto temp = first++;
-			res = erase(temp);
-		}
-		return res;
+			first = erase(first);
+		return last;
+	}
+
+	template <class T>
+	typename list<T>::node_type list<T>::extract(iterator position) {
+		unlinkNode(position.p);
+		position.p->prev = position.p->next = nullptr;
+		return node_type(static_cast<nodeptr>(position.p));
+	}
+
+	template <class T>
+	typename list<T>::iterator list<T>::insert(iterator position, node_type&& nh) {
+		if (nh.empty())
+			return position;
+
+		auto node = nh.ptr_;
+		nh.ptr_ = nullptr;
+		linkBefore(position.p, node);
+		return iterator(node);
 	}
 
 	template <class T>
 	void list<T>::clear(){
-		erase(begin(), end());
+		auto node = header_.next;
+		while (node != &header_) {
+			auto next = node->next;
+			deleteNode(static_cast<nodeptr>(node));
+			node = next;
+		}
+		init();
 	}
 
 	template <class T>
 	typename list<T>::iterator list<T>::begin(){
-		return head;
+		return iterator(header_.next);
 	}
 
 	template <class T>
 	typename list<T>::iterator list<T>::end() {
-		return tail;
+		return iterator(&header_);
 	}
 
 	template <class T>
-	void list<T>::reverse()
-	{
-		if (empty() || head.p->next == tail.p)
-			return;
+	typename list<T>::const_iterator list<T>::begin() const {
+		return const_iterator(header_.next);
+	}
 
-		auto curNode = head.p;
-		head.p = tail.p->prev;
-		head.p->prev = nullptr;
+	template <class T>
+	typename list<T>::const_iterator list<T>::end() const {
+		return const_iterator(const_cast<node_base*>(&header_));
+	}
 
+	template <class T>
+	void list<T>::reverse()
+	{
+		node_base* cur = &header_;
 		do {
-			auto nextNode = curNode->next;
-			curNode->next = head.p->next;
-			head.p->next->prev = curNode;
-			head.p->next = curNode;
-			curNode->prev = head.p;
-			curNode = nextNode;
-		} while (curNode != head.p);
+			miniSTL::swap(cur->prev, cur->next);
+			cur = cur->prev;
+		} while (cur != &header_);
 	}
 
 	template <class T>
@@ -297,8 +479,16 @@ namespace miniSTL
 
 	template <class T>
 	void list<T>::swap(list<T>& x){
-		miniSTL::swap(head.p, x.head.p);
-		miniSTL::swap(tail.p, x.tail.p);
+		bool thisEmpty = empty(), xEmpty = x.empty();
+		miniSTL::swap(header_, x.header_);
+		if (xEmpty)
+			init();
+		else
+			fixHeader();
+		if (thisEmpty)
+			x.init();
+		else
+			x.fixHeader();
 	}
 
 	template <class T>
@@ -309,149 +499,85 @@ namespace miniSTL
 	template <class T>
 	void list<T>::unique()
 	{
-		nodeptr curNode = head.p;
-		while (curNode != tail.p)
-		{
-			nodeptr nextNode = curNode->next;
-			if (curNode->data == nextNode->data)
-			{
-				if (nextNode == tail.p)
-				{
-					curNode->next = nullptr;
-					tail.p = curNode;
-				}
-				else
-				{
-					curNode->next = nextNode->next;
-					nextNode->next->prev = curNode;
-				}
-				deleteNode(nextNode);
-			}
-			else
-				curNode = nextNode;
-		}
+		unique(miniSTL::equal_to<T>());
 	}
 
 	template <class T>
 	template <class Predicate>
 	void list<T>::unique(Predicate binary_pred)
 	{
-		nodeptr curNode = head.p;
-		while (curNode != tail.p)
-		{
-			nodeptr nextNode = curNode->next;
-			if (binary_pred(curNode->data, nextNode->data))
-			{
-				if (nextNode == tail.p)
-				{
-					curNode->next = nullptr;
-					tail.p = curNode;
-				}
-				else
-				{
-					curNode->next = nextNode->next;
-					nextNode->next->prev = curNode;
-				}
-				deleteNode(nextNode);
-			}
+		if (empty())
+			return;
+
+		auto first = begin(), next = begin();
+		for (++next; next != end();) {
+			if (binary_pred(*first, *next))
+				next = erase(next);
 			else
-				curNode = nextNode;
+				first = next++;
 		}
 	}
 
 	template <class T>
 	void list<T>::splice(iterator position, list& x){
-		insert(position, x.begin(), x.end());
-		x.head.p = x.tail.p;
+		if (this != &x)
+			transfer(position.p, x.header_.next, &x.header_);
 	}
 
 	template <class T>
-	void list<T>::splice(iterator position, list& x, iterator first, iterator last) {
-		if (first.p == last.p)
-			return;
-
-		auto tailNode = last.p->prev;
-		if (x.head.p == first.p)
-		{
-			x.head.p = last.p;
-			x.head.p->prev = nullptr;
-		}
-		else
-		{
-			first.p->prev->next = last.p;
-			last.p->prev = first.p->prev;
-		}
-
-		if (position.p == head.p)
-		{
-			first.p->prev = nullptr;
-			tailNode->next = head.p;
-			head.p->prev = tailNode;
-			head.p = first.p;
-		}
-		else
-		{
-			position.p->prev->next = first.p;
-			first.p->prev = position.p->prev;
-			tailNode->next = position.p;
-			position.p->prev = tailNode;
-		}
+	void list<T>::splice(iterator position, list&, iterator first, iterator last) {
+		transfer(position.p, first.p, last.p);
 	}
 
 	template <class T>
-	void list<T>::splice(iterator position, list& x, iterator i){
+	void list<T>::splice(iterator position, list&, iterator i){
 		auto next = i;
-		splice(position, x, i, ++next);
+		++next;
+		if (position == i || position == next)
+			return;
+		transfer(position.p, i.p, next.p);
 	}
 
 	template <class T>
-	void list<T>::merge(list<T>& x)
+	void list<T>::merge(list<T>& x) {
+		merge(x, miniSTL::less<T>());
+	}
+
+	template<class T>
+	template <class Compare>
+	void list<T>::merge(list& x, Compare comp)
 	{
-		auto it1 = begin(), it2 = x.begin();
-		while (it1 != end() && it2 != x.end())
-		{
-			if (*it1 <= *it2)
-				++it1;
-			else
-			{
-				auto temp = it2++;
-				splice(it1, x, temp);
-			}
-		}
+		if (this == &x || x.empty())
+			return;
 
-		if (it1 == end()){
-			splice(it1, x, it2, x.end());
-		}
+		Detail::list_node_compare<Detail::Node<T>, Compare> nodeComp(comp);
+		linkAll(Detail::list_merge_chains(unlinkAll(), x.unlinkAll(), nodeComp));
+	}
+
+	template <class T>
+	void list<T>::sort() {
+		sort(miniSTL::less<T>());
 	}
 
 	template<class T>
 	template <class Compare>
-	void list<T>::merge(list& x, Compare comp)
+	void list<T>::sort(Compare comp)
 	{
-		auto it1 = begin(), it2 = x.begin();
-		while (it1 != end() && it2 != x.end()) {
-			if (comp(*it2, *it1)) {
-				auto temp = it2++;
-				this->splice(it1, x, temp);
-			}
-			else
-				++it1;
-		}
-		if (it1 == end()) {
-			this->splice(it1, x, it2, x.end());
-		}
+		if (empty() || header_.next->next == &header_)
+			return;
+
+		Detail::list_node_compare<Detail::Node<T>, Compare> nodeComp(comp);
+		linkAll(Detail::list_sort_chain(unlinkAll(), nodeComp));
 	}
 
 	template <class T>
 	bool operator== (const list<T>& lhs, const list<T>& rhs) {
-		auto node1 = lhs.head.p, node2 = rhs.head.p;
-		for (; node1 != lhs.tail.p && node2 != rhs.tail.p; node1 = node1->next, node2 = node2->next) {
-			if (node1->data != node2->data)
-				break;
+		auto it1 = lhs.begin(), it2 = rhs.begin();
+		for (; it1 != lhs.end() && it2 != rhs.end(); ++it1, ++it2) {
+			if (*it1 != *it2)
+				return false;
 		}
-		if (node1 == lhs.tail.p && node2 == rhs.tail.p)
-			return true;
-		return false;
+		return it1 == lhs.end() && it2 == rhs.end();
 	}
 	template <class T>
 	bool operator!= (const list<T>& lhs, const list<T>& rhs) {
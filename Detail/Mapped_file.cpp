@@ -0,0 +1,60 @@
+#include "../Mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace miniSTL
+{
+#ifdef _WIN32
+	Mapped_file::Mapped_file(const char* path) : data_(nullptr), size_(0), file_(INVALID_HANDLE_VALUE), mapping_(nullptr) {
+		file_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER bytes;
+		if (!GetFileSizeEx(file_, &bytes) || bytes.QuadPart == 0)
+			return;
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping_)
+			return;
+		data_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+		if (data_)
+			size_ = static_cast<size_t>(bytes.QuadPart);
+	}
+
+	Mapped_file::~Mapped_file() {
+		if (data_)
+			UnmapViewOfFile(data_);
+		if (mapping_)
+			CloseHandle(mapping_);
+		if (file_ != INVALID_HANDLE_VALUE)
+			CloseHandle(file_);
+	}
+#else
+	//the descriptor is closed straight away, the mapping keeps the file alive
+	Mapped_file::Mapped_file(const char* path) : data_(nullptr), size_(0) {
+		int fd = open(path, O_RDONLY);
+		if (fd < 0)
+			return;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0) {
+			void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+			if (p != MAP_FAILED) {
+				data_ = p;
+				size_ = static_cast<size_t>(st.st_size);
+			}
+		}
+		close(fd);
+	}
+
+	Mapped_file::~Mapped_file() {
+		if (data_)
+			munmap(const_cast<void*>(data_), size_);
+	}
+#endif
+}
@@ -0,0 +1,38 @@
+#ifndef _UNORDERED_MAP_IMPL_H_
+#define _UNORDERED_MAP_IMPL_H_
+
+namespace miniSTL
+{
+	template<class Key, class T, class Hash, class EqualKey, class Allocator, class Policy>
+	typename Unordered_map<Key, T, Hash, EqualKey, Allocator, Policy>::mapped_type&
+		Unordered_map<Key, T, Hash, EqualKey, Allocator, Policy>::operator[](const key_type& key) {
+		return try_emplace(key).first->second;
+	}
+
+	//the node is built as pair(key, mapped_type(args...)) in place, after the lookup has missed
+	template<class Key, class T, class Hash, class EqualKey, class Allocator, class Policy>
+	template<class... Args>
+	miniSTL::pair<typename Unordered_map<Key, T, Hash, EqualKey, Allocator, Policy>::iterator, bool>
+		Unordered_map<Key, T, Hash, EqualKey, Allocator, Policy>::try_emplace(const key_type& key, Args&&... args) {
+		return table_.emplaceHashed(key, table_.hash_(key), construct_second, key, std::forward<Args>(args)...);
+	}
+
+	//obj is only forwarded once, into the new node or onto the existing mapped value
+	template<class Key, class T, class Hash, class EqualKey, class Allocator, class Policy>
+	template<class M>
+	miniSTL::pair<typename Unordered_map<Key, T, Hash, EqualKey, Allocator, Policy>::iterator, bool>
+		Unordered_map<Key, T, Hash, EqualKey, Allocator, Policy>::insert_or_assign(const key_type& key, M&& obj) {
+		auto res = table_.emplaceHashed(key, table_.hash_(key), construct_second, key, std::forward<M>(obj));
+		if (!res.second)
+			res.first->second = std::forward<M>(obj);
+		return res;
+	}
+
+	template<class Key, class T, class Hash, class EqualKey, class Allocator, class Policy>
+	void swap(Unordered_map<Key, T, Hash, EqualKey, Allocator, Policy>& lhs,
+		Unordered_map<Key, T, Hash, EqualKey, Allocator, Policy>& rhs) {
+		lhs.swap(rhs);
+	}
+}
+
+#endif
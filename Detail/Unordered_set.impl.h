@@ -7,321 +7,1041 @@ namespace miniSTL
 {
 	namespace Detail
 	{
-		template<class Key, class ListIterator, class Hash, class EqualKey, class Allocator>
-		ust_iterator<Key, ListIterator, Hash, EqualKey, Allocator>::ust_iterator(size_t size, ListIterator it, cntrPtr ptr)
-			: bucket_index_(size), iterator_(it), container_(ptr) {}
-
-		template<class Key, class ListIterator, class Hash, class EqualKey, class Allocator>
-		ust_iterator<Key, ListIterator, Hash, EqualKey, Allocator>&
-		ust_iterator<Key, ListIterator, Hash, EqualKey, Allocator>::operator ++() {
-			++iterator_;
-			if (iterator_ == container_->buckets_[bucket_index_].end())
-			{
-				while (true)
-				{
-					if (bucket_index_ == container_->buckets_.size() - 1) {
-						*this = container_->end();
-						break;
-					}
-					else
-					{
-						++bucket_index_;
-						if (!(container_->buckets_[bucket_index_].empty())){
-							iterator_ = container_->buckets_[bucket_index_].begin();
-							break;
-						}
-					}
-				}
+		template <class Dummy>
+		const size_t ust_prime_table<Dummy>::list[ust_prime_table<Dummy>::size] = {
+			53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317, 196613, 393241,
+			786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611,
+			402653189, 805306457, 1610612741, 3221225473u, 4294967291u
+		};
+
+		template <class Dummy>
+		size_t ust_prime_table<Dummy>::next(size_t n) {
+			auto i = 0;
+			for (; i != size; ++i) {
+				if (n > list[i])
+					continue;
+				else
+					break;
+			}
+			i = (i == size ? size - 1 : i);
+			return list[i];
+		}
+
+		template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey, class Ref, class Ptr>
+		ust_iterator<Key, Hash, EqualKey, Allocator, Policy, ExtractKey, Ref, Ptr>::ust_iterator(size_t index, ust_node_base* node, cntrPtr ptr)
+			: bucket_index_(index), node_(node), container_(ptr) {}
+
+		template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey, class Ref, class Ptr>
+		ust_iterator<Key, Hash, EqualKey, Allocator, Policy, ExtractKey, Ref, Ptr>&
+		ust_iterator<Key, Hash, EqualKey, Allocator, Policy, ExtractKey, Ref, Ptr>::operator ++() {
+			node_ = node_->next;
+			if (!node_) {
+				bucket_index_ = container_->nextBucket(bucket_index_ + 1);
+				if (bucket_index_ != container_->totalBuckets())
+					node_ = container_->bucketAt(bucket_index_);
 			}
 			return *this;
 		}
 
-		template<class Key, class ListIterator, class Hash, class EqualKey, class Allocator>
-		ust_iterator<Key, ListIterator, Hash, EqualKey, Allocator>
-			ust_iterator<Key, ListIterator, Hash, EqualKey, Allocator>::operator ++(int) {
+		template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey, class Ref, class Ptr>
+		ust_iterator<Key, Hash, EqualKey, Allocator, Policy, ExtractKey, Ref, Ptr>
+			ust_iterator<Key, Hash, EqualKey, Allocator, Policy, ExtractKey, Ref, Ptr>::operator ++(int) {
 			auto res = *this;
 			++*this;
 			return res;
 		}
-
-		template<class Key, class ListIterator, class Hash, class KeyEqual, class Allocator>
-		bool operator ==(const ust_iterator<Key, ListIterator, Hash, KeyEqual, Allocator>& lhs,
-			const ust_iterator<Key, ListIterator, Hash, KeyEqual, Allocator>& rhs) {
-			return lhs.bucket_index_ == rhs.bucket_index_ &&
-				lhs.iterator_ == rhs.iterator_ &&
-				lhs.container_ == rhs.container_;
-		}
-
-		template<class Key, class ListIterator, class Hash, class EqualKey, class Allocator>
-		bool operator !=(const ust_iterator<Key, ListIterator, Hash, EqualKey, Allocator>& lhs,
-			const ust_iterator<Key, ListIterator, Hash, EqualKey, Allocator>& rhs) {
-			return !(lhs == rhs);
-		}
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::size_type
-		Unordered_set<Key, Hash, EqualKey, Allocator>::size() const {
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::size() const {
 		return size_;
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	bool Unordered_set<Key, Hash, EqualKey, Allocator>::empty() const {
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	bool Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::empty() const {
 		return size() == 0;
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::size_type
-		Unordered_set<Key, Hash, EqualKey, Allocator>::bucket_count() const {
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::bucket_count() const {
 		return buckets_.size();
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	typename Unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
-		Unordered_set<Key, Hash, KeyEqual, Allocator>::bucket_size(size_type i)const {
-		return buckets_[i].size();
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::bucket_size(size_type i)const {
+		size_type n = 0;
+		for (auto p = buckets_[i]; p; p = p->next)
+			++n;
+		return n;
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	typename Unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
-		Unordered_set<Key, Hash, KeyEqual, Allocator>::bucket(const key_type& key)const {
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::bucket(const key_type& key)const {
 		return bucket_index(key);
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	float Unordered_set<Key, Hash, EqualKey, Allocator>::load_factor() const {
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	float Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::load_factor() const {
 		return (float)size() / (float)bucket_count();
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::haser
-		Unordered_set<Key, Hash, EqualKey, Allocator>::hash_function() const {
-		return haser();
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::haser
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::hash_function() const {
+		return hash_;
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::equal_key
-		Unordered_set<Key, Hash, EqualKey, Allocator>::key_eq() const {
-		return equal_key();
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::equal_key
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::key_eq() const {
+		return equal_;
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::allocator_type
-		Unordered_set<Key, Hash, EqualKey, Allocator>::get_allocator()const {
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::allocator_type
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::get_allocator()const {
 		return allocator_type();
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	size_t Unordered_set<Key, Hash, EqualKey, Allocator>::prime_list_[PRIME_LIST_SIZE] = {
-		53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317, 196613, 393241,
-		786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611,
-		402653189, 805306457, 1610612741, 3221225473, 4294967291
-	};
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class... Args>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::nodeptr
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::newNode(Args&&... args) {
+		nodeptr p = nodeAllocator::allocate();
+		new(p) node(std::forward<Args>(args)...);
+		return p;
+	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	bool Unordered_set<Key, Hash, EqualKey, Allocator>::has_key(const key_type& key) {
-		auto& list = buckets_[bucket_index(key)];
-		auto pred = std::bind(EqualKey(), key, std::placeholders::_1);
-		return miniSTL::find_if(list.begin(), list.end(), pred) != list.end();
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::deleteNode(nodeptr p) {
+		nodeAllocator::destroy(p);
+		nodeAllocator::deallocate(p);
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::size_type
-		Unordered_set<Key, Hash, EqualKey, Allocator>::bucket_index(const key_type& key)const {
-		return haser()(key) % buckets_.size();
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class K>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::node_base*
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::findInChain(node_base* p, const K& key, size_type hash)const {
+		for (; p; p = p->next) {
+			//a cached hash rejects most non-matching nodes without comparing keys
+			if (hashMatches(p, hash, std::integral_constant<bool, cache_hash>()) &&
+				equal_(keyOf(static_cast<nodeptr>(p)->value), key))
+				return p;
+		}
+		return nullptr;
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::size_type
-		Unordered_set<Key, Hash, EqualKey, Allocator>::next_prime(size_type n)const {
-		auto i = 0;
-		for (; i != PRIME_LIST_SIZE; ++i) {
-			if (n > prime_list_[i])
-				continue;
-			else 
-				break;
+	//search the new table, then the old one if its bucket has not migrated yet
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class K>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::node_base*
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::findNode(const K& key, size_type hash, size_type& index)const {
+		//a filtered miss needs no bucket index, callers only read index when a node is returned
+		if (!mayContain(hash))
+			return nullptr;
+		index = bucket_index_of_hash(hash);
+		node_base* p = findInChain(buckets_[index], key, hash);
+		if (!p && !old_buckets_.empty()) {
+			size_type old = old_policy_.index(hash);
+			if (old >= migrate_index_) {
+				p = findInChain(old_buckets_[old], key, hash);
+				index = buckets_.size() + old;
+			}
 		}
-		i = (i == PRIME_LIST_SIZE ? PRIME_LIST_SIZE - 1 : i);
-		return prime_list_[i];
+		return p;
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	Unordered_set<Key, Hash, EqualKey, Allocator>::Unordered_set(const Unordered_set& ust) {
-		buckets_ = ust.buckets_;
+	//clone every chain in order, the bucket count is the same so no key is hashed again
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::cloneChains(bucket_vector& dst,
+		const bucket_vector& src) {
+		dst.resize(src.size(), nullptr);
+		for (size_type i = 0; i != src.size(); ++i) {
+			node_base** tail = &dst[i];
+			for (auto p = src[i]; p; p = p->next) {
+				//the node copy constructor also carries the cached hash over
+				nodeptr q = newNode(static_cast<const node&>(*p));
+				*tail = q;
+				tail = &q->next;
+			}
+		}
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::copyBuckets(const Unordered_set& ust) {
+		cloneChains(buckets_, ust.buckets_);
+		cloneChains(old_buckets_, ust.old_buckets_);
+		occupied_ = ust.occupied_;
+		old_occupied_ = ust.old_occupied_;
+		policy_ = ust.policy_;
+		old_policy_ = ust.old_policy_;
+		migrate_index_ = ust.migrate_index_;
 		size_ = ust.size_;
 		max_load_factor_ = ust.max_load_factor_;
+		min_load_factor_ = ust.min_load_factor_;
+		filter_ = ust.filter_;
+		old_filter_ = ust.old_filter_;
+		filter_erased_ = ust.filter_erased_;
+		incremental_ = ust.incremental_;
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::bucket_index(const key_type& key)const {
+		return policy_.index(hash_(key));
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::Unordered_set(const Unordered_set& ust)
+		: hash_(ust.hash_), equal_(ust.equal_) {
+		copyBuckets(ust);
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	Unordered_set<Key, Hash, EqualKey, Allocator>& Unordered_set<Key, Hash, EqualKey, Allocator>::operator = (const Unordered_set& ust) {
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>& Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::operator = (const Unordered_set& ust) {
 		if (this != &ust) {
-			buckets_ = ust.buckets_;
-			size_ = ust.size_;
-			max_load_factor_ = ust.max_load_factor_;
+			Unordered_set temp(ust);
+			swap(temp);
 		}
 		return *this;
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	Unordered_set<Key, Hash, EqualKey, Allocator>::Unordered_set(size_type bucket_count) {
-		bucket_count = next_prime(bucket_count);
-		buckets_.resize(bucket_count);
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::~Unordered_set() {
+		clear();
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::Unordered_set(size_type bucket_count, const haser& hash, const equal_key& equal)
+		: hash_(hash), equal_(equal) {
+		migrate_index_ = 0;
 		size_ = 0;
 		max_load_factor_ = 1.0;
+		min_load_factor_ = 0;
+		filter_erased_ = 0;
+		incremental_ = false;
+		initBuckets(bucket_count);
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
 	template<class InputIterator>
-	Unordered_set<Key, Hash, EqualKey, Allocator>::Unordered_set(InputIterator first, InputIterator last) {
+	Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::Unordered_set(InputIterator first, InputIterator last) {
+		migrate_index_ = 0;
 		size_ = 0;
 		max_load_factor_ = 1.0;
-		auto len = last - first;
-		buckets_.resize(next_prime(len));
+		min_load_factor_ = 0;
+		filter_erased_ = 0;
+		incremental_ = false;
+		buildFrom(first, last, typename Detail::ust_range_category<InputIterator>::type());
+	}
 
-		for (; first != last; ++first) {
-			auto index = bucket_index(*first);
-			if (!has_key(*first)) {
-				buckets_[index].push_front(*first);
-				++size_;
-			}
-		}
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::initBuckets(size_type n) {
+		buckets_.resize(Policy::next_size(n), nullptr);
+		occupied_.resize(Detail::ust_bitmap_words(buckets_.size()), 0);
+		policy_.reset(buckets_.size());
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::iterator
-		Unordered_set<Key, Hash, EqualKey, Allocator>::begin() {
-		size_type index = 0;
-		for (; index != buckets_.size(); ++index) {
-			if (!(buckets_[index].empty()))
-				break;
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class InputIterator>
+	void Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::buildFrom(InputIterator first, InputIterator last,
+		Detail::ust_single_pass) {
+		initBuckets(0);
+		insertRange(first, last, Detail::ust_single_pass());
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class ForwardIterator>
+	void Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::buildFrom(ForwardIterator first, ForwardIterator last,
+		Detail::ust_multi_pass) {
+		initBuckets(Detail::ust_range_length(first, last, typename Detail::ust_range_category<ForwardIterator>::type()));
+		insertBulk(first, last);
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::iterator
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::begin() {
+		size_type index = nextBucket(0);
+		return index != totalBuckets() ? iterator(index, bucketAt(index), this) : end();
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::nextBucket(size_type i)const {
+		const size_type n = buckets_.size();
+		if (i < n) {
+			size_type next = Detail::ust_bitmap_next(occupied_, i, n);
+			if (next != n)
+				return next;
+			i = n;
 		}
-		if (index == buckets_.size())
-			return end();
-		return iterator(index, buckets_[index].begin(), this);
+		return n + Detail::ust_bitmap_next(old_occupied_, i - n, old_buckets_.size());
+	}
+
+	//clear the bit of bucket i once its chain has become empty
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::markEmpty(size_type i) {
+		if (i < buckets_.size())
+			Detail::ust_bitmap_reset(occupied_, i);
+		else
+			Detail::ust_bitmap_reset(old_occupied_, i - buckets_.size());
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::linkFront(bucket_vector& buckets, bitmap_vector& occupied,
+		size_type index, node_base* p) {
+		p->next = buckets[index];
+		buckets[index] = p;
+		Detail::ust_bitmap_set(occupied, index);
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::iterator 
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::end(){
+		return iterator(totalBuckets(), nullptr, this);
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::const_iterator
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::begin()const {
+		size_type index = nextBucket(0);
+		return index != totalBuckets() ? const_iterator(index, bucketAt(index), this) : end();
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::const_iterator
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::end()const {
+		return const_iterator(totalBuckets(), nullptr, this);
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::local_iterator
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::begin(size_type i) {
+		return local_iterator(buckets_[i]);
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::local_iterator
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::end(size_type) {
+		return local_iterator(nullptr);
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class K>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::iterator
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::findHashed(const K& key, size_type hash) {
+		rehashStep();
+		size_type index;
+		auto p = findNode(key, hash, index);
+		return p ? iterator(index, p, this) : end();
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::iterator
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::find(const key_type& key) {
+		return findHashed(key, hash_(key));
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	typename Unordered_set<Key, Hash, KeyEqual, Allocator>::iterator 
-		Unordered_set<Key, Hash, KeyEqual, Allocator>::end(){
-		return iterator(buckets_.size() - 1, buckets_[buckets_.size() - 1].end(), this);
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::iterator
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::find(const key_type& key, size_type hash) {
+		return findHashed(key, hash);
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::local_iterator
-		Unordered_set<Key, Hash, EqualKey, Allocator>::begin(size_type i) {
-		return buckets_[i].begin();
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class K>
+	typename Detail::ust_enable_transparent<Hash, EqualKey, K, typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::iterator>::type
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::find(const K& key) {
+		return findHashed(key, hash_(key));
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::local_iterator
-		Unordered_set<Key, Hash, EqualKey, Allocator>::end(size_type i) {
-		return buckets_[i].end();
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class K>
+	typename Detail::ust_enable_transparent<Hash, EqualKey, K, typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::iterator>::type
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::find(const K& key, size_type hash) {
+		return findHashed(key, hash);
 	}
 
-	template<class Key, class Hash, class EqualKey, class Allocator>
-	typename Unordered_set<Key, Hash, EqualKey, Allocator>::iterator
-		Unordered_set<Key, Hash, EqualKey, Allocator>::find(const key_type& key) {
-		auto index = bucket_index(key);
-		for (auto it = begin(index); it != end(index); ++it) {
-			if (equal_key()(key, *it))
-				return iterator(index, it, this);
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::count(const key_type& key) {
+		return findHashed(key, hash_(key)) == end() ? 0 : 1;
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::count(const key_type& key, size_type hash) {
+		return findHashed(key, hash) == end() ? 0 : 1;
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	template<class K>
+	typename Detail::ust_enable_transparent<Hash, KeyEqual, K, typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type>::type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::count(const K& key) {
+		return findHashed(key, hash_(key)) == end() ? 0 : 1;
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	template<class K>
+	typename Detail::ust_enable_transparent<Hash, KeyEqual, K, typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type>::type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::count(const K& key, size_type hash) {
+		return findHashed(key, hash) == end() ? 0 : 1;
+	}
+
+	/*
+	 * three passes over each group of BATCH_SIZE keys: hash and prefetch the bucket slots, load the
+	 * heads and prefetch the first nodes, then walk the chains. the misses of one pass are in flight
+	 * together instead of one key waiting on the previous key's node. with the Bloom filter on, a
+	 * first pass prefetches the filter blocks instead and the slots are only fetched for the keys
+	 * the filter lets through.
+	 * the migration steps once per call, so no node moves while the results are produced.
+	 */
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class ForwardIterator, class Visit>
+	void Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::probeBatch(ForwardIterator first, ForwardIterator last, Visit visit) {
+		rehashStep();
+		const bool filtered = !filter_.empty() && old_filter_.empty();
+		ForwardIterator keys[BATCH_SIZE];
+		size_type hashes[BATCH_SIZE];
+		size_type indexes[BATCH_SIZE];
+		bool maybe[BATCH_SIZE];
+		while (first != last) {
+			int n = 0;
+			for (; n != BATCH_SIZE && first != last; ++n, ++first) {
+				keys[n] = first;
+				hashes[n] = hash_(*first);
+				indexes[n] = bucket_index_of_hash(hashes[n]);
+				maybe[n] = true;
+				if (filtered)
+					Detail::ust_bloom_prefetch(filter_, hashes[n]);
+				else
+					Detail::ust_prefetch(&buckets_[indexes[n]]);
+			}
+			if (filtered) {
+				for (int i = 0; i != n; ++i) {
+					maybe[i] = Detail::ust_bloom_test(filter_, hashes[i]);
+					if (maybe[i])
+						Detail::ust_prefetch(&buckets_[indexes[i]]);
+				}
+			}
+			for (int i = 0; i != n; ++i) {
+				if (maybe[i] && buckets_[indexes[i]])
+					Detail::ust_prefetch(buckets_[indexes[i]]);
+			}
+			for (int i = 0; i != n; ++i) {
+				size_type index = indexes[i];
+				node_base* p = maybe[i] ? findNode(*keys[i], hashes[i], index) : nullptr;
+				visit(p, index);
+			}
 		}
-		return end();
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	typename Unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
-		Unordered_set<Key, Hash, KeyEqual, Allocator>::count(const key_type& key) {
-		auto it = find(key);
-		return it == end() ? 0 : 1;
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class ForwardIterator, class OutputIterator>
+	OutputIterator Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::find_batch(ForwardIterator first, ForwardIterator last,
+		OutputIterator result) {
+		probeBatch(first, last, [&](node_base* p, size_type index) {
+			*result = p ? iterator(index, p, this) : end();
+			++result;
+		});
+		return result;
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class ForwardIterator, class OutputIterator>
+	OutputIterator Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::contains_batch(ForwardIterator first, ForwardIterator last,
+		OutputIterator result) {
+		probeBatch(first, last, [&](node_base* p, size_type) {
+			*result = p != nullptr;
+			++result;
+		});
+		return result;
+	}
+
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template<class ForwardIterator>
+	typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::count_batch(ForwardIterator first, ForwardIterator last) {
+		size_type n = 0;
+		probeBatch(first, last, [&](node_base* p, size_type) {
+			if (p)
+				++n;
+		});
+		return n;
+	}
+
+	template <class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	miniSTL::pair<typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::iterator, bool>
+	Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::insert(const value_type& val)
+	{
+		return emplaceHashed(keyOf(val), hash_(keyOf(val)), val);
+	}
+
+	template <class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	miniSTL::pair<typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::iterator, bool>
+	Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::insert(const value_type& val, size_type hash)
+	{
+		return emplaceHashed(keyOf(val), hash, val);
 	}
 
-	template <class Key, class Hash, class EqualKey, class Allocator>
-	miniSTL::pair<typename Unordered_set<Key, Hash, EqualKey, Allocator>::iterator, bool>
-	Unordered_set<Key, Hash, EqualKey, Allocator>::insert(const value_type& val)
+	template <class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
+	template <class K, class... Args>
+	miniSTL::pair<typename Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::iterator, bool>
+	Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>::emplaceHashed(const K& key, size_type hash, Args&&... args)
 	{
-		if (!has_key(val))
-		{
-			if (load_factor() > max_load_factor())
-				rehash(next_prime(size()));
+		rehashStep();
+		size_type index;
+		auto p = findNode(key, hash, index);
+		if (p)
+			return miniSTL::pair<iterator, bool>(iterator(index, p, this), false);
 
-			auto index = bucket_index(val);
-			buckets_[index].push_front(val);
-			++size_;
+		if (load_factor() > max_load_factor())
+			rehash(Policy::next_size(size()));
 
-			return miniSTL::pair<iterator, bool>(iterator(index, buckets_[index].begin(), this), true);
-		}
-		return miniSTL::pair<iterator, bool>(end(), false);
+		//new keys always go to the new table
+		index = bucket_index_of_hash(hash);
+		nodeptr q = newNode(std::forward<Args>(args)...);
+		storeHash(q, hash, std::integral_constant<bool, cache_hash>());
+		linkFront(buckets_, occupied_, index, q);
+		addToFilter(hash);
+		++size_;
+
+		return miniSTL::pair<iterator, bool>(iterator(index, q, this), true);
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
 	template<class InputIterator>
-	void Unordered_set<Key, Hash, KeyEqual, Allocator>::insert(InputIterator first, InputIterator last) {
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::insert(InputIterator first, InputIterator last) {
+		insertRange(first, last, typename Detail::ust_range_category<InputIterator>::type());
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	template<class InputIterator>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::insertRange(InputIterator first, InputIterator last,
+		Detail::ust_single_pass) {
 		for (; first != last; ++first)
 			insert(*first);
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	typename Unordered_set<Key, Hash, KeyEqual, Allocator>::iterator
-		Unordered_set<Key, Hash, KeyEqual, Allocator>::erase(iterator position) {
-		--size_;
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	template<class ForwardIterator>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::insertRange(ForwardIterator first, ForwardIterator last,
+		Detail::ust_multi_pass) {
+		reserve(size() + Detail::ust_range_length(first, last, typename Detail::ust_range_category<ForwardIterator>::type()));
+		insertBulk(first, last);
+	}
+
+	//the table already has room for the whole range, so keys are hashed a group at a time and linked in
+	//with no load factor check. duplicates only make the reservation larger than needed
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	template<class ForwardIterator>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::insertBulk(ForwardIterator first, ForwardIterator last) {
+		rehashStep();
+		ForwardIterator keys[BATCH_SIZE];
+		size_type hashes[BATCH_SIZE];
+		size_type indexes[BATCH_SIZE];
+		while (first != last) {
+			int n = 0;
+			for (; n != BATCH_SIZE && first != last; ++n, ++first) {
+				keys[n] = first;
+				hashes[n] = hash_(keyOf(*first));
+				indexes[n] = bucket_index_of_hash(hashes[n]);
+				Detail::ust_prefetch(&buckets_[indexes[n]]);
+			}
+			for (int i = 0; i != n; ++i) {
+				size_type index;
+				if (findNode(keyOf(*keys[i]), hashes[i], index))
+					continue;
+				nodeptr q = newNode(*keys[i]);
+				storeHash(q, hashes[i], std::integral_constant<bool, cache_hash>());
+				linkFront(buckets_, occupied_, indexes[i], q);
+				addToFilter(hashes[i]);
+				++size_;
+			}
+		}
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::iterator
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::erase(iterator position) {
 		auto t = position++;
-		auto index = t.bucket_index_;
-		buckets_[index].erase(t.iterator_);
+		node_base** link = &bucketAt(t.bucket_index_);
+		while (*link != t.node_)
+			link = &(*link)->next;
+		*link = t.node_->next;
+		if (!bucketAt(t.bucket_index_))
+			markEmpty(t.bucket_index_);
+		deleteNode(static_cast<nodeptr>(t.node_));
+		--size_;
+		//refilling the filter only rewrites filter words, position stays valid
+		noteErased(1);
 		return position;
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	typename Unordered_set<Key, Hash, KeyEqual, Allocator>::size_type
-		Unordered_set<Key, Hash, KeyEqual, Allocator>::erase(const key_type& key) {
-		auto it = find(key);
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::erase(const key_type& key) {
+		return eraseKey(key);
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	template<class K>
+	typename Detail::ust_enable_transparent<Hash, KeyEqual, K, typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type>::type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::erase(const K& key) {
+		return eraseKey(key);
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	template<class K>
+	typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::eraseKey(const K& key) {
+		auto it = findHashed(key, hash_(key));
 		if (it == end()) {
 			return 0;
 		}
 		else {
 			erase(it);
+			shrinkIfSparse();
 			return 1;
 		}
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	void Unordered_set<Key, Hash, KeyEqual, Allocator>::clear()
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::clear()
 	{
-		for (int i = 0; i < buckets_.size(); ++i)
-			buckets_[i].clear();
-
+		//only the occupied buckets are visited, and their bits cleared on the way
+		for (size_type i = nextBucket(0); i != totalBuckets(); i = nextBucket(i + 1)) {
+			node_base*& head = bucketAt(i);
+			node_base* p = head;
+			while (p) {
+				node_base* next = p->next;
+				deleteNode(static_cast<nodeptr>(p));
+				p = next;
+			}
+			head = nullptr;
+			markEmpty(i);
+		}
+		bucket_vector().swap(old_buckets_);
+		bitmap_vector().swap(old_occupied_);
+		filter_vector().swap(old_filter_);
+		for (auto& word : filter_)
+			word = 0;
+		filter_erased_ = 0;
+		migrate_index_ = 0;
 		size_ = 0;
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	float Unordered_set<Key, Hash, KeyEqual, Allocator>::max_load_factor()const {
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	float Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::max_load_factor()const {
 		return max_load_factor_;
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	void Unordered_set<Key, Hash, KeyEqual, Allocator>::max_load_factor(float z) {
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::max_load_factor(float z) {
 		max_load_factor_ = z;
+		if (min_load_factor_ > z / 8)
+			min_load_factor_ = z / 8;
+	}
+
+	//move every node of a chain to its bucket in buckets, nothing is allocated, copied or compared.
+	//the chain always moves into the table filter_ belongs to, so the filter learns its hashes
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::relinkChain(node_base* p, bucket_vector& buckets,
+		bitmap_vector& occupied, const Policy& policy) {
+		while (p) {
+			node_base* next = p->next;
+			const size_type hash = nodeHash(p, std::integral_constant<bool, cache_hash>());
+			linkFront(buckets, occupied, policy.index(hash), p);
+			if (!filter_.empty())
+				Detail::ust_bloom_add(filter_, hash);
+			p = next;
+		}
+	}
+
+	//drain at most REHASH_STEP non-empty old buckets, the bitmap skips the empty ones a word at a time
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::rehashStep() {
+		if (old_buckets_.empty())
+			return;
+
+		const size_type old_count = old_buckets_.size();
+		for (int moved = 0; moved != REHASH_STEP; ++moved) {
+			migrate_index_ = Detail::ust_bitmap_next(old_occupied_, migrate_index_, old_count);
+			if (migrate_index_ == old_count)
+				break;
+			relinkChain(old_buckets_[migrate_index_], buckets_, occupied_, policy_);
+			old_buckets_[migrate_index_] = nullptr;
+			Detail::ust_bitmap_reset(old_occupied_, migrate_index_);
+			++migrate_index_;
+		}
+		if (migrate_index_ == old_count) {
+			bucket_vector().swap(old_buckets_);
+			bitmap_vector().swap(old_occupied_);
+			filter_vector().swap(old_filter_);
+			migrate_index_ = 0;
+		}
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::finishRehash() {
+		const size_type old_count = old_buckets_.size();
+		for (size_type i = Detail::ust_bitmap_next(old_occupied_, migrate_index_, old_count); i != old_count;
+			i = Detail::ust_bitmap_next(old_occupied_, i + 1, old_count))
+			relinkChain(old_buckets_[i], buckets_, occupied_, policy_);
+		bucket_vector().swap(old_buckets_);
+		bitmap_vector().swap(old_occupied_);
+		filter_vector().swap(old_filter_);
+		migrate_index_ = 0;
+	}
+
+	//relink the existing nodes into exactly count buckets, larger or smaller, in incremental mode only the first step runs now
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::rebuild(size_type count, bool incremental) {
+		finishRehash();
+		bucket_vector buckets;
+		buckets.resize(count, nullptr);
+		bitmap_vector occupied;
+		occupied.resize(Detail::ust_bitmap_words(buckets.size()), 0);
+		Policy policy;
+		policy.reset(buckets.size());
+		if (incremental) {
+			old_buckets_.swap(buckets_);
+			buckets_.swap(buckets);
+			old_occupied_.swap(occupied_);
+			occupied_.swap(occupied);
+			old_policy_ = policy_;
+			policy_ = policy;
+			if (!filter_.empty()) {
+				old_filter_.swap(filter_);
+				resetFilter(count);
+			}
+			rehashStep();
+			return;
+		}
+
+		if (!filter_.empty())
+			resetFilter(count);
+
+		const size_type old_count = buckets_.size();
+		for (size_type i = Detail::ust_bitmap_next(occupied_, 0, old_count); i != old_count; i = Detail::ust_bitmap_next(occupied_, i + 1, old_count))
+			relinkChain(buckets_[i], buckets, occupied, policy);
+		buckets_.swap(buckets);
+		occupied_.swap(occupied);
+		policy_ = policy;
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	void Unordered_set<Key, Hash, KeyEqual, Allocator>::rehash(size_type n) {
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::rehash(size_type n) {
 		if (n <= buckets_.size())
 			return;
+		rebuild(Policy::next_size(n), incremental_);
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::reserve(size_type n) {
+		rehash(bucketsFor(n));
+	}
+
+	//the smallest table holding size() keys within max_load_factor(), relinked at once and the old arrays freed
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::shrink_to_fit() {
+		finishRehash();
+		const size_type count = Policy::next_size(bucketsFor(size_));
+		if (count < buckets_.size())
+			rebuild(count, false);
+	}
 
-		Unordered_set temp(next_prime(n));
-		for (auto& val : *this) {
-			temp.insert(val);
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	typename Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::size_type
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::bucketsFor(size_type n)const {
+		return static_cast<size_type>(std::ceil(static_cast<double>(n) / max_load_factor_));
+	}
+
+	//a sparse table is rebuilt for a load of about half max_load_factor(), the policy's rounding up
+	//leaves it between a quarter and a half, well clear of both the min and the max
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::shrinkIfSparse() {
+		if (min_load_factor_ <= 0 || load_factor() >= min_load_factor_)
+			return;
+		const size_type count = Policy::next_size(bucketsFor(size_ * 2));
+		if (count < buckets_.size())
+			rebuild(count, incremental_);
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::min_load_factor(float z) {
+		min_load_factor_ = z < max_load_factor_ / 8 ? z : max_load_factor_ / 8;
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::incremental_rehash(bool enable) {
+		incremental_ = enable;
+		if (!enable)
+			finishRehash();
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::bloom_filter(bool enable) {
+		if (!enable) {
+			filter_vector().swap(filter_);
+			filter_vector().swap(old_filter_);
+			return;
+		}
+		if (filter_.empty()) {
+			finishRehash();
+			resetFilter(buckets_.size());
+			refillFilter();
 		}
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::resetFilter(size_type bucket_count) {
+		filter_vector filter;
+		filter.resize(Detail::ust_bloom_words(static_cast<size_type>(std::ceil(bucket_count * static_cast<double>(max_load_factor_)))), 0);
+		filter_.swap(filter);
+		filter_erased_ = 0;
+	}
+
+	//add every key again, walking the occupied buckets, only called with no migration in flight
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::refillFilter() {
+		for (auto& word : filter_)
+			word = 0;
+		const size_type count = buckets_.size();
+		for (size_type i = Detail::ust_bitmap_next(occupied_, 0, count); i != count; i = Detail::ust_bitmap_next(occupied_, i + 1, count)) {
+			for (node_base* p = buckets_[i]; p; p = p->next)
+				Detail::ust_bloom_add(filter_, nodeHash(p, std::integral_constant<bool, cache_hash>()));
+		}
+		filter_erased_ = 0;
+	}
+
+	//while migrating, old_filter_ is the one that has seen every key
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	bool Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::mayContain(size_type hash)const {
+		if (!old_filter_.empty())
+			return Detail::ust_bloom_test(old_filter_, hash);
+		return filter_.empty() || Detail::ust_bloom_test(filter_, hash);
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::addToFilter(size_type hash) {
+		if (!filter_.empty())
+			Detail::ust_bloom_add(filter_, hash);
+		if (!old_filter_.empty())
+			Detail::ust_bloom_add(old_filter_, hash);
+	}
+
+	//at 8 bits a key the filter was sized for four keys a word
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::noteErased(size_type n) {
+		if (filter_.empty())
+			return;
+		filter_erased_ += n;
+		if (filter_erased_ > filter_.size() * 4 && old_buckets_.empty())
+			refillFilter();
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::prefetchProbe(size_type hash)const {
+		if (!filter_.empty() && old_filter_.empty())
+			Detail::ust_bloom_prefetch(filter_, hash);
+		else
+			Detail::ust_prefetch(&buckets_[bucket_index_of_hash(hash)]);
+	}
+
+	/*
+	 * other's chains are detached a bucket at a time and their nodes handled in groups of BATCH_SIZE:
+	 * hash them and prefetch where they would land here, then probe. a node whose key is already
+	 * here goes back to its bucket in other, the rest are linked in here as they are
+	 */
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::merge(Unordered_set& other) {
+		if (&other == this)
+			return;
+		rehashStep();
+		other.finishRehash();
+		const size_type count = other.buckets_.size();
+		node_base* nodes[BATCH_SIZE];
+		size_type hashes[BATCH_SIZE];
+		size_type homes[BATCH_SIZE];
+		size_type i = Detail::ust_bitmap_next(other.occupied_, 0, count);
+		size_type home = 0;
+		node_base* p = nullptr; //rest of the chain detached from bucket home of other
+		size_type moved = 0;
+		while (p || i != count) {
+			int n = 0;
+			for (; n != BATCH_SIZE; ++n) {
+				if (!p) {
+					if (i == count)
+						break;
+					home = i;
+					p = other.buckets_[home];
+					other.buckets_[home] = nullptr;
+					Detail::ust_bitmap_reset(other.occupied_, home);
+					i = Detail::ust_bitmap_next(other.occupied_, home + 1, count);
+				}
+				nodes[n] = p;
+				homes[n] = home;
+				hashes[n] = other.nodeHash(p, std::integral_constant<bool, cache_hash>());
+				prefetchProbe(hashes[n]);
+				p = p->next;
+			}
+			for (int k = 0; k != n; ++k) {
+				size_type index;
+				if (findNode(keyOf(static_cast<nodeptr>(nodes[k])->value), hashes[k], index)) {
+					linkFront(other.buckets_, other.occupied_, homes[k], nodes[k]);
+					continue;
+				}
+				if (load_factor() > max_load_factor())
+					rehash(Policy::next_size(size()));
+				linkFront(buckets_, occupied_, bucket_index_of_hash(hashes[k]), nodes[k]);
+				addToFilter(hashes[k]);
+				++size_;
+				++moved;
+			}
+		}
+		other.size_ -= moved;
+		other.noteErased(moved);
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::collectMatches(const Unordered_set& other, bool present,
+		size_type from, size_type to, match_vector& out)const {
+		const node_base* nodes[BATCH_SIZE];
+		size_type hashes[BATCH_SIZE];
+		size_type i = nextBucket(from);
+		const node_base* p = i < to ? bucketAt(i) : nullptr;
+		while (p) {
+			int n = 0;
+			for (; n != BATCH_SIZE && p; ++n) {
+				nodes[n] = p;
+				hashes[n] = nodeHash(p, std::integral_constant<bool, cache_hash>());
+				other.prefetchProbe(hashes[n]);
+				p = p->next;
+				if (!p) {
+					i = nextBucket(i + 1);
+					p = i < to ? bucketAt(i) : nullptr;
+				}
+			}
+			for (int k = 0; k != n; ++k) {
+				size_type index;
+				bool found = other.findNode(keyOf(static_cast<const node*>(nodes[k])->value), hashes[k], index) != nullptr;
+				if (found == present) {
+					match m = { nodes[k], hashes[k] };
+					out.push_back(m);
+				}
+			}
+		}
+	}
+
+	//both sets are only read while the threads run, each thread fills its own part
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::collectMatches(const Unordered_set& other, bool present,
+		size_type threads, match_vector& out)const {
+		const size_type total = totalBuckets();
+		if (threads <= 1) {
+			collectMatches(other, present, 0, total, out);
+			return;
+		}
+		const size_type chunk = (total + threads - 1) / threads;
+		miniSTL::vector<match_vector> parts(threads);
+		std::vector<std::thread> pool;
+		for (size_type t = 0; t != threads; ++t) {
+			const size_type from = t * chunk < total ? t * chunk : total;
+			const size_type to = from + chunk < total ? from + chunk : total;
+			pool.push_back(std::thread([this, &other, present, from, to, &parts, t]() {
+				collectMatches(other, present, from, to, parts[t]);
+			}));
+		}
+		for (auto& th : pool)
+			th.join();
+		size_type n = 0;
+		for (auto& part : parts)
+			n += static_cast<size_type>(part.size());
+		out.reserve(static_cast<size_type>(out.size()) + n);
+		for (auto& part : parts)
+			out.insert(out.end(), part.begin(), part.end());
+	}
+
+	//a table sized once for the matches, filled with copies of their nodes and no probing
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::fromMatches(const match_vector& matches)const {
+		Unordered_set result(bucketsFor(static_cast<size_type>(matches.size())), hash_, equal_);
+		result.max_load_factor_ = max_load_factor_;
+		for (auto& m : matches)
+			result.linkCopy(m.node, m.hash);
+		return result;
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::linkCopy(const node_base* p, size_type hash) {
+		//the node copy constructor also carries the cached hash over
+		nodeptr q = newNode(static_cast<const node&>(*p));
+		linkFront(buckets_, occupied_, bucket_index_of_hash(hash), q);
+		addToFilter(hash);
+		++size_;
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::intersect(const Unordered_set& other, size_type threads)const {
+		match_vector matches;
+		if (other.size_ < size_)
+			other.collectMatches(*this, true, threads, matches);
+		else
+			collectMatches(other, true, threads, matches);
+		return fromMatches(matches);
+	}
+
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::difference(const Unordered_set& other, size_type threads)const {
+		match_vector matches;
+		collectMatches(other, false, threads, matches);
+		return fromMatches(matches);
+	}
+
+	//the missing keys are all found before dst changes, so dst is reserved once and nothing is probed twice
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::union_into(Unordered_set& dst, size_type threads)const {
+		if (&dst == this)
+			return;
+		match_vector missing;
+		collectMatches(dst, false, threads, missing);
+		dst.reserve(dst.size_ + static_cast<size_type>(missing.size()));
+		for (auto& m : missing)
+			dst.linkCopy(m.node, m.hash);
+	}
 
-		miniSTL::swap(*this, temp);
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>::swap(Unordered_set& ust) {
+		buckets_.swap(ust.buckets_);
+		old_buckets_.swap(ust.old_buckets_);
+		occupied_.swap(ust.occupied_);
+		old_occupied_.swap(ust.old_occupied_);
+		miniSTL::swap(policy_, ust.policy_);
+		miniSTL::swap(old_policy_, ust.old_policy_);
+		miniSTL::swap(migrate_index_, ust.migrate_index_);
+		miniSTL::swap(size_, ust.size_);
+		miniSTL::swap(max_load_factor_, ust.max_load_factor_);
+		miniSTL::swap(min_load_factor_, ust.min_load_factor_);
+		filter_.swap(ust.filter_);
+		old_filter_.swap(ust.old_filter_);
+		miniSTL::swap(filter_erased_, ust.filter_erased_);
+		miniSTL::swap(incremental_, ust.incremental_);
+		miniSTL::swap(hash_, ust.hash_);
+		miniSTL::swap(equal_, ust.equal_);
 	}
 
-	template<class Key, class Hash, class KeyEqual, class Allocator>
-	void swap(Unordered_set<Key, Hash, KeyEqual, Allocator>& lhs,
-		Unordered_set<Key, Hash, KeyEqual, Allocator>& rhs) {
-		miniSTL::swap(lhs.buckets_, rhs.buckets_);
-		miniSTL::swap(lhs.size_, rhs.size_);
-		miniSTL::swap(lhs.max_load_factor_, rhs.max_load_factor_);
+	template<class Key, class Hash, class KeyEqual, class Allocator, class Policy, class ExtractKey>
+	void swap(Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>& lhs,
+		Unordered_set<Key, Hash, KeyEqual, Allocator, Policy, ExtractKey>& rhs) {
+		lhs.swap(rhs);
 	}
 }
 
@@ -0,0 +1,127 @@
+#ifndef _UNORDERED_SET_IMAGE_IMPL_H_
+#define _UNORDERED_SET_IMAGE_IMPL_H_
+
+#include <cmath>
+#include <cstring>
+
+namespace miniSTL
+{
+	//every bound is checked against bytes before any offset or key is trusted
+	template<class Key, class Hash, class EqualKey, class Policy>
+	Unordered_set_image<Key, Hash, EqualKey, Policy>::Unordered_set_image(const void* data, size_type bytes,
+		const haser& hash, const equal_key& equal)
+		: offsets_(nullptr), keys_(nullptr), size_(0), bucket_count_(0), hash_(hash), equal_(equal) {
+		const char* base = static_cast<const char*>(data);
+		if (!base || reinterpret_cast<uintptr_t>(base) % alignof(uint64_t) != 0 || bytes < sizeof(Detail::usi_header))
+			return;
+		Detail::usi_header header;
+		memcpy(&header, base, sizeof(header));
+		if (memcmp(header.magic, Detail::usi_magic, sizeof(header.magic)) != 0 || header.version != Detail::usi_version
+			|| header.key_size != sizeof(Key) || header.byte_order != Detail::usi_byte_order)
+			return;
+		if (header.keys_offset > bytes || header.keys_offset % 64 != 0 || header.keys_offset % alignof(Key) != 0
+			|| header.size > (bytes - header.keys_offset) / sizeof(Key))
+			return;
+		if (header.bucket_count == 0 || header.bucket_count >= header.keys_offset / sizeof(uint64_t)
+			|| sizeof(header) + (header.bucket_count + 1) * sizeof(uint64_t) > header.keys_offset
+			|| header.bucket_count != Policy::next_size(static_cast<size_type>(header.bucket_count)))
+			return;
+		const uint64_t* offsets = reinterpret_cast<const uint64_t*>(base + sizeof(header));
+		if (offsets[0] != 0 || offsets[header.bucket_count] != header.size)
+			return;
+
+		offsets_ = offsets;
+		keys_ = reinterpret_cast<const Key*>(base + header.keys_offset);
+		size_ = static_cast<size_type>(header.size);
+		bucket_count_ = static_cast<size_type>(header.bucket_count);
+		policy_.reset(bucket_count_);
+	}
+
+	template<class Key, class Hash, class EqualKey, class Policy>
+	typename Unordered_set_image<Key, Hash, EqualKey, Policy>::const_iterator
+		Unordered_set_image<Key, Hash, EqualKey, Policy>::find(const key_type& key, size_type hash)const {
+		if (!keys_)
+			return end();
+		const size_type b = policy_.index(hash);
+		//the offsets are not walked on open, so a damaged one is caught here instead
+		const uint64_t from = offsets_[b], to = offsets_[b + 1];
+		if (from >= to || to > size_)
+			return end();
+		for (const Key* p = keys_ + from, *last = keys_ + to; p != last; ++p) {
+			if (equal_(*p, key))
+				return p;
+		}
+		return end();
+	}
+
+	//a counting sort by bucket: one pass hashes and counts, one places the keys,
+	//then each bucket drops the keys it already holds
+	template<class Key, class Hash, class EqualKey, class Policy>
+	template<class ForwardIterator>
+	bool Unordered_set_image<Key, Hash, EqualKey, Policy>::write(std::ostream& out, ForwardIterator first, ForwardIterator last,
+		float load, const haser& hash, const equal_key& equal) {
+		if (!(load > 0))
+			return false;
+		size_type n = 0;
+		for (auto it = first; it != last; ++it)
+			++n;
+		const size_type count = Policy::next_size(static_cast<size_type>(std::ceil(static_cast<double>(n) / load)));
+		Policy policy;
+		policy.reset(count);
+
+		miniSTL::vector<uint64_t> offsets;
+		offsets.resize(count + 1, 0);
+		miniSTL::vector<size_type> index;
+		index.resize(n, 0);
+		size_type i = 0;
+		for (auto it = first; it != last; ++it, ++i) {
+			index[i] = policy.index(hash(*it));
+			++offsets[index[i] + 1];
+		}
+		for (size_type b = 0; b != count; ++b)
+			offsets[b + 1] += offsets[b];
+
+		miniSTL::vector<Key> keys;
+		miniSTL::vector<uint64_t> fill(offsets);
+		if (n != 0)
+			keys.resize(n, *first);
+		i = 0;
+		for (auto it = first; it != last; ++it, ++i)
+			keys[fill[index[i]]++] = *it;
+
+		uint64_t kept = 0;
+		for (size_type b = 0; b != count; ++b) {
+			const uint64_t from = offsets[b], to = offsets[b + 1];
+			offsets[b] = kept;
+			for (uint64_t j = from; j != to; ++j) {
+				uint64_t k = offsets[b];
+				while (k != kept && !equal(keys[k], keys[j]))
+					++k;
+				if (k == kept)
+					keys[kept++] = keys[j];
+			}
+		}
+		offsets[count] = kept;
+
+		Detail::usi_header header;
+		memcpy(header.magic, Detail::usi_magic, sizeof(header.magic));
+		header.version = Detail::usi_version;
+		header.key_size = sizeof(Key);
+		header.byte_order = Detail::usi_byte_order;
+		header.reserved = 0;
+		header.size = kept;
+		header.bucket_count = count;
+		const uint64_t table_end = sizeof(header) + (count + 1) * sizeof(uint64_t);
+		header.keys_offset = (table_end + 63) / 64 * 64;
+
+		const char pad[64] = {};
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(&offsets[0]), (count + 1) * sizeof(uint64_t));
+		out.write(pad, static_cast<std::streamsize>(header.keys_offset - table_end));
+		if (kept != 0)
+			out.write(reinterpret_cast<const char*>(&keys[0]), static_cast<std::streamsize>(kept * sizeof(Key)));
+		return out.good();
+	}
+}
+
+#endif
@@ -0,0 +1,643 @@
+#ifndef _UNROLLED_LIST_IMPL_H_
+#define _UNROLLED_LIST_IMPL_H_
+
+namespace miniSTL
+{
+	namespace Detail
+	{
+		template <class T, size_t N, class Ref, class Ptr>
+		ul_iterator<T, N, Ref, Ptr>& ul_iterator<T, N, Ref, Ptr>::operator++() {
+			if (++index_ == static_cast<nodeptr>(node_)->count) {
+				node_ = node_->next;
+				index_ = 0;
+			}
+			return *this;
+		}
+
+		template <class T, size_t N, class Ref, class Ptr>
+		ul_iterator<T, N, Ref, Ptr> ul_iterator<T, N, Ref, Ptr>::operator++(int) {
+			auto res = *this;
+			++*this;
+			return res;
+		}
+
+		template <class T, size_t N, class Ref, class Ptr>
+		ul_iterator<T, N, Ref, Ptr>& ul_iterator<T, N, Ref, Ptr>::operator--() {
+			if (index_ == 0) {
+				node_ = node_->prev;
+				index_ = static_cast<nodeptr>(node_)->count - 1;
+			}
+			else
+				--index_;
+			return *this;
+		}
+
+		template <class T, size_t N, class Ref, class Ptr>
+		ul_iterator<T, N, Ref, Ptr> ul_iterator<T, N, Ref, Ptr>::operator--(int) {
+			auto res = *this;
+			--*this;
+			return res;
+		}
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::init() {
+		header_.prev = header_.next = &header_;
+		size_ = 0;
+	}
+
+	template <class T, size_t N>
+	typename unrolled_list<T, N>::nodeptr unrolled_list<T, N>::newNode() {
+		nodeptr res = nodeAllocator::allocate();
+		res->prev = res->next = nullptr;
+		res->count = 0;
+		return res;
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::deleteNode(nodeptr p) {
+		for (size_type i = 0; i != p->count; ++i)
+			p->data()[i].~T();
+		nodeAllocator::deallocate(p);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::linkBefore(node_base* position, node_base* p) {
+		p->next = position;
+		p->prev = position->prev;
+		position->prev->next = p;
+		position->prev = p;
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::unlink(node_base* p) {
+		p->prev->next = p->next;
+		p->next->prev = p->prev;
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::fixHeader() {
+		if (size_ == 0) {
+			header_.prev = header_.next = &header_;
+		}
+		else {
+			header_.next->prev = &header_;
+			header_.prev->next = &header_;
+		}
+	}
+
+	//move [at, count) of p into a fresh node linked right after p
+	template <class T, size_t N>
+	typename unrolled_list<T, N>::nodeptr unrolled_list<T, N>::splitNode(nodeptr p, size_type at) {
+		nodeptr q = newNode();
+		T* src = p->data();
+		T* dst = q->data();
+		for (size_type i = at; i != p->count; ++i) {
+			new(dst + (i - at)) T(std::move(src[i]));
+			src[i].~T();
+		}
+		q->count = p->count - at;
+		p->count = at;
+		linkBefore(p->next, q);
+		return q;
+	}
+
+	template <class T, size_t N>
+	template <class U>
+	typename unrolled_list<T, N>::iterator unrolled_list<T, N>::insertAux(iterator position, U&& val) {
+		if (position.node_ == &header_) {
+			nodeptr tail = static_cast<nodeptr>(header_.prev);
+			if (header_.prev == &header_ || tail->count == N) {
+				tail = newNode();
+				linkBefore(&header_, tail);
+			}
+			new(tail->data() + tail->count) T(std::forward<U>(val));
+			++tail->count;
+			++size_;
+			return iterator(tail, tail->count - 1);
+		}
+
+		nodeptr p = static_cast<nodeptr>(position.node_);
+		size_type idx = position.index_;
+
+		//inserting in front of a node, the previous node may still have room at its end
+		if (idx == 0 && p->prev != &header_ && static_cast<nodeptr>(p->prev)->count != N) {
+			nodeptr q = static_cast<nodeptr>(p->prev);
+			new(q->data() + q->count) T(std::forward<U>(val));
+			++q->count;
+			++size_;
+			return iterator(q, q->count - 1);
+		}
+
+		if (p->count == N) {
+			nodeptr q = splitNode(p, N / 2);
+			if (idx > p->count) {
+				idx -= p->count;
+				p = q;
+			}
+		}
+
+		T* d = p->data();
+		if (idx == p->count) {
+			new(d + idx) T(std::forward<U>(val));
+		}
+		else {
+			new(d + p->count) T(std::move(d[p->count - 1]));
+			for (size_type i = p->count - 1; i != idx; --i)
+				d[i] = std::move(d[i - 1]);
+			d[idx] = std::forward<U>(val);
+		}
+		++p->count;
+		++size_;
+		return iterator(p, idx);
+	}
+
+	//destroy every element from position to the end
+	template <class T, size_t N>
+	void unrolled_list<T, N>::truncate(iterator position) {
+		node_base* cur = position.node_;
+		if (cur == &header_)
+			return;
+
+		if (position.index_ != 0) {
+			nodeptr p = static_cast<nodeptr>(cur);
+			for (size_type i = position.index_; i != p->count; ++i)
+				p->data()[i].~T();
+			size_ -= p->count - position.index_;
+			p->count = position.index_;
+			cur = cur->next;
+		}
+
+		while (cur != &header_) {
+			nodeptr p = static_cast<nodeptr>(cur);
+			cur = cur->next;
+			size_ -= p->count;
+			unlink(p);
+			deleteNode(p);
+		}
+	}
+
+	//relink every node of l in front of position, no element is touched
+	template <class T, size_t N>
+	void unrolled_list<T, N>::transferNodes(node_base* position, unrolled_list& l) {
+		if (l.empty())
+			return;
+
+		node_base* first = l.header_.next;
+		node_base* last = l.header_.prev;
+		first->prev = position->prev;
+		position->prev->next = first;
+		last->next = position;
+		position->prev = last;
+
+		size_ += l.size_;
+		l.init();
+	}
+
+	//step past an element that has been moved out, freeing its node once the node is used up
+	template <class T, size_t N>
+	void unrolled_list<T, N>::consume(iterator& it) {
+		nodeptr p = static_cast<nodeptr>(it.node_);
+		if (++it.index_ == p->count) {
+			it = iterator(p->next, 0);
+			size_ -= p->count;
+			unlink(p);
+			deleteNode(p);
+		}
+	}
+
+	template <class T, size_t N>
+	typename unrolled_list<T, N>::size_type unrolled_list<T, N>::offsetOf(iterator position) const {
+		size_type offset = 0;
+		for (node_base* cur = header_.next; cur != position.node_; cur = cur->next)
+			offset += static_cast<nodeptr>(cur)->count;
+		return offset + position.index_;
+	}
+
+	template <class T, size_t N>
+	typename unrolled_list<T, N>::iterator unrolled_list<T, N>::iteratorAt(size_type offset) {
+		node_base* cur = header_.next;
+		while (cur != &header_ && offset >= static_cast<nodeptr>(cur)->count) {
+			offset -= static_cast<nodeptr>(cur)->count;
+			cur = cur->next;
+		}
+		return iterator(cur, offset);
+	}
+
+	template <class T, size_t N>
+	template <class Compare>
+	void unrolled_list<T, N>::sortNode(nodeptr p, Compare comp) {
+		T* d = p->data();
+		for (size_type i = 1; i < p->count; ++i) {
+			if (!comp(d[i], d[i - 1]))
+				continue;
+
+			T temp(std::move(d[i]));
+			size_type j = i;
+			do {
+				d[j] = std::move(d[j - 1]);
+				--j;
+			} while (j != 0 && comp(temp, d[j - 1]));
+			d[j] = std::move(temp);
+		}
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::ctorAux(size_type n, const value_type& val, std::true_type) {
+		init();
+		while (n--)
+			push_back(val);
+	}
+
+	template <class T, size_t N>
+	template <class InputIterator>
+	void unrolled_list<T, N>::ctorAux(InputIterator first, InputIterator last, std::false_type) {
+		init();
+		for (; first != last; ++first)
+			push_back(*first);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::insert_aux(iterator position, size_type n, const T& val, std::true_type) {
+		for (; n != 0; --n) {
+			position = insert(position, val);
+			++position;
+		}
+	}
+
+	template <class T, size_t N>
+	template <class InputIterator>
+	void unrolled_list<T, N>::insert_aux(iterator position, InputIterator first, InputIterator last, std::false_type) {
+		for (; first != last; ++first) {
+			position = insert(position, *first);
+			++position;
+		}
+	}
+
+	template <class T, size_t N>
+	unrolled_list<T, N>::unrolled_list() {
+		init();
+	}
+
+	template <class T, size_t N>
+	unrolled_list<T, N>::unrolled_list(size_type n, const value_type& val) {
+		ctorAux(n, val, std::true_type());
+	}
+
+	template <class T, size_t N>
+	template <class InputIterator>
+	unrolled_list<T, N>::unrolled_list(InputIterator first, InputIterator last) {
+		ctorAux(first, last, typename std::is_integral<InputIterator>::type());
+	}
+
+	template <class T, size_t N>
+	unrolled_list<T, N>::unrolled_list(const unrolled_list& l) {
+		init();
+		for (auto it = l.begin(); it != l.end(); ++it)
+			push_back(*it);
+	}
+
+	template <class T, size_t N>
+	unrolled_list<T, N>::unrolled_list(unrolled_list&& l) {
+		init();
+		transferNodes(&header_, l);
+	}
+
+	template <class T, size_t N>
+	unrolled_list<T, N>& unrolled_list<T, N>::operator = (const unrolled_list& l) {
+		if (this != &l) {
+			unrolled_list(l).swap(*this);
+		}
+		return *this;
+	}
+
+	template <class T, size_t N>
+	unrolled_list<T, N>& unrolled_list<T, N>::operator = (unrolled_list&& l) {
+		if (this != &l) {
+			clear();
+			transferNodes(&header_, l);
+		}
+		return *this;
+	}
+
+	template <class T, size_t N>
+	unrolled_list<T, N>::~unrolled_list() {
+		clear();
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::push_front(const value_type& val) {
+		insertAux(begin(), val);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::push_front(value_type&& val) {
+		insertAux(begin(), std::move(val));
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::pop_front() {
+		erase(begin());
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::push_back(const value_type& val) {
+		insertAux(end(), val);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::push_back(value_type&& val) {
+		insertAux(end(), std::move(val));
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::pop_back() {
+		erase(--end());
+	}
+
+	template <class T, size_t N>
+	typename unrolled_list<T, N>::iterator unrolled_list<T, N>::insert(iterator position, const value_type& val) {
+		return insertAux(position, val);
+	}
+
+	template <class T, size_t N>
+	typename unrolled_list<T, N>::iterator unrolled_list<T, N>::insert(iterator position, value_type&& val) {
+		return insertAux(position, std::move(val));
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::insert(iterator position, size_type n, const value_type& val) {
+		insert_aux(position, n, val, std::true_type());
+	}
+
+	template <class T, size_t N>
+	template <class InputIterator>
+	void unrolled_list<T, N>::insert(iterator position, InputIterator first, InputIterator last) {
+		insert_aux(position, first, last, typename std::is_integral<InputIterator>::type());
+	}
+
+	template <class T, size_t N>
+	typename unrolled_list<T, N>::iterator unrolled_list<T, N>::erase(iterator position) {
+		nodeptr p = static_cast<nodeptr>(position.node_);
+		size_type idx = position.index_;
+		T* d = p->data();
+
+		for (size_type i = idx; i + 1 < p->count; ++i)
+			d[i] = std::move(d[i + 1]);
+		d[p->count - 1].~T();
+		--p->count;
+		--size_;
+
+		if (p->count == 0) {
+			node_base* next = p->next;
+			unlink(p);
+			deleteNode(p);
+			return iterator(next, 0);
+		}
+
+		//fold a sparse neighbour back in so nodes stay reasonably full
+		if (p->next != &header_) {
+			nodeptr q = static_cast<nodeptr>(p->next);
+			if (p->count + q->count <= N / 2) {
+				T* src = q->data();
+				for (size_type i = 0; i != q->count; ++i) {
+					new(d + p->count + i) T(std::move(src[i]));
+					src[i].~T();
+				}
+				p->count += q->count;
+				q->count = 0;
+				unlink(q);
+				deleteNode(q);
+			}
+		}
+
+		if (idx == p->count)
+			return iterator(p->next, 0);
+		return iterator(p, idx);
+	}
+
+	template <class T, size_t N>
+	typename unrolled_list<T, N>::iterator unrolled_list<T, N>::erase(iterator first, iterator last) {
+		if (last == end()) {
+			truncate(first);
+			return end();
+		}
+
+		size_type n = 0;
+		for (auto it = first; it != last; ++it)
+			++n;
+		for (; n != 0; --n)
+			first = erase(first);
+		return first;
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::clear() {
+		truncate(begin());
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::swap(unrolled_list& l) {
+		miniSTL::swap(header_, l.header_);
+		miniSTL::swap(size_, l.size_);
+		fixHeader();
+		l.fixHeader();
+	}
+
+	template <class T, size_t N>
+	void swap(unrolled_list<T, N>& x, unrolled_list<T, N>& y) {
+		x.swap(y);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::splice(iterator position, unrolled_list& l) {
+		if (this == &l || l.empty())
+			return;
+
+		node_base* at = position.node_;
+		if (position.index_ != 0)
+			at = splitNode(static_cast<nodeptr>(at), position.index_);
+		transferNodes(at, l);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::splice(iterator position, unrolled_list& l, iterator i) {
+		auto next = i;
+		splice(position, l, i, ++next);
+	}
+
+	//partial ranges are moved element by element, whole nodes are only relinked by splice(position, l)
+	template <class T, size_t N>
+	void unrolled_list<T, N>::splice(iterator position, unrolled_list& l, iterator first, iterator last) {
+		if (first == last)
+			return;
+
+		unrolled_list temp;
+		if (this == &l) {
+			size_type pos = offsetOf(position), from = offsetOf(first), n = 0;
+			for (auto it = first; it != last; ++it, ++n)
+				temp.push_back(std::move(*it));
+			erase(first, last);
+			if (pos > from)
+				pos -= n;
+			splice(iteratorAt(pos), temp);
+		}
+		else {
+			for (auto it = first; it != last; ++it)
+				temp.push_back(std::move(*it));
+			l.erase(first, last);
+			splice(position, temp);
+		}
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::remove(const value_type& val) {
+		remove_if([&val](const value_type& x) { return x == val; });
+	}
+
+	template <class T, size_t N>
+	template <class Predicate>
+	void unrolled_list<T, N>::remove_if(Predicate pred) {
+		auto dest = begin();
+		for (auto it = begin(); it != end(); ++it) {
+			if (!pred(*it)) {
+				if (dest != it)
+					*dest = std::move(*it);
+				++dest;
+			}
+		}
+		truncate(dest);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::unique() {
+		unique(miniSTL::equal_to<T>());
+	}
+
+	template <class T, size_t N>
+	template <class BinaryPredicate>
+	void unrolled_list<T, N>::unique(BinaryPredicate binary_pred) {
+		if (empty())
+			return;
+
+		auto dest = begin(), it = begin();
+		for (++it; it != end(); ++it) {
+			if (!binary_pred(*dest, *it)) {
+				++dest;
+				if (dest != it)
+					*dest = std::move(*it);
+			}
+		}
+		truncate(++dest);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::merge(unrolled_list& l) {
+		merge(l, miniSTL::less<T>());
+	}
+
+	//the merged sequence is written into freshly packed nodes while the source nodes are freed as they drain
+	template <class T, size_t N>
+	template <class Compare>
+	void unrolled_list<T, N>::merge(unrolled_list& l, Compare comp) {
+		if (this == &l || l.empty())
+			return;
+		if (empty()) {
+			transferNodes(&header_, l);
+			return;
+		}
+
+		unrolled_list res;
+		auto it1 = begin(), it2 = l.begin();
+		while (it1 != end() && it2 != l.end()) {
+			if (comp(*it2, *it1)) {
+				res.push_back(std::move(*it2));
+				l.consume(it2);
+			}
+			else {
+				res.push_back(std::move(*it1));
+				consume(it1);
+			}
+		}
+
+		for (; it1 != end() && it1.index_ != 0; consume(it1))
+			res.push_back(std::move(*it1));
+		for (; it2 != l.end() && it2.index_ != 0; l.consume(it2))
+			res.push_back(std::move(*it2));
+
+		res.transferNodes(&res.header_, *this);
+		res.transferNodes(&res.header_, l);
+		swap(res);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::sort() {
+		sort(miniSTL::less<T>());
+	}
+
+	//each node is insertion sorted in place, then the sorted nodes are merged bottom-up through 64 bins
+	template <class T, size_t N>
+	template <class Compare>
+	void unrolled_list<T, N>::sort(Compare comp) {
+		if (size_ < 2)
+			return;
+
+		unrolled_list carry;
+		unrolled_list counter[64];
+		int fill = 0;
+		while (!empty()) {
+			nodeptr p = static_cast<nodeptr>(header_.next);
+			unlink(p);
+			size_ -= p->count;
+			sortNode(p, comp);
+			carry.linkBefore(&carry.header_, p);
+			carry.size_ = p->count;
+
+			int i = 0;
+			while (i < fill && !counter[i].empty()) {
+				counter[i].merge(carry, comp);
+				carry.swap(counter[i++]);
+			}
+			carry.swap(counter[i]);
+			if (i == fill)
+				++fill;
+		}
+
+		for (int i = 1; i < fill; ++i)
+			counter[i].merge(counter[i - 1], comp);
+		swap(counter[fill - 1]);
+	}
+
+	template <class T, size_t N>
+	void unrolled_list<T, N>::reverse() {
+		node_base* cur = &header_;
+		do {
+			miniSTL::swap(cur->prev, cur->next);
+			if (cur != &header_) {
+				nodeptr p = static_cast<nodeptr>(cur);
+				T* d = p->data();
+				for (size_type i = 0, j = p->count - 1; i < j; ++i, --j)
+					std::swap(d[i], d[j]);
+			}
+			cur = cur->prev;
+		} while (cur != &header_);
+	}
+
+	template <class T, size_t N>
+	bool operator== (const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs) {
+		if (lhs.size() != rhs.size())
+			return false;
+		for (auto it1 = lhs.begin(), it2 = rhs.begin(); it1 != lhs.end(); ++it1, ++it2) {
+			if (*it1 != *it2)
+				return false;
+		}
+		return true;
+	}
+
+	template <class T, size_t N>
+	bool operator!= (const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs) {
+		return !(lhs == rhs);
+	}
+}
+
+#endif
@@ -159,7 +159,7 @@ namespace miniSTL
 		InputIterator last,
 		std::false_type) {
 		difference_type locationLeft = endOfStorage_ - finish_; 
-		difference_type locationNeed = distance(first, last);
+		difference_type locationNeed = miniSTL::distance(first, last);
 
 		if (locationLeft >= locationNeed) {
 			if (finish_ - position > locationNeed) {
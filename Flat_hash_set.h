@@ -0,0 +1,330 @@
+#ifndef _FLAT_HASH_SET_H_
+#define _FLAT_HASH_SET_H_
+
+#include "Allocator.h"
+#include "Functional.h"
+#include "Iterator.h"
+#include "Utility.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINISTL_FHS_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace miniSTL
+{
+	namespace Detail
+	{
+		/*
+		 * one control byte per slot:
+		 * full slots hold the low 7 bits of the hash (0..127),
+		 * the special states are negative so a single signed compare separates them
+		 */
+		typedef signed char fhs_ctrl;
+		const fhs_ctrl fhs_empty = -128;
+		const fhs_ctrl fhs_deleted = -2;
+		const fhs_ctrl fhs_sentinel = -1;
+
+		inline int fhs_ctz(uint64_t x) {
+#ifdef _MSC_VER
+			unsigned long index;
+#ifdef _M_X64
+			_BitScanForward64(&index, x);
+#else
+			if (static_cast<uint32_t>(x) != 0)
+				_BitScanForward(&index, static_cast<uint32_t>(x));
+			else {
+				_BitScanForward(&index, static_cast<uint32_t>(x >> 32));
+				index += 32;
+			}
+#endif
+			return static_cast<int>(index);
+#else
+			return __builtin_ctzll(x);
+#endif
+		}
+
+		inline int fhs_clz(uint64_t x) {
+#ifdef _MSC_VER
+			unsigned long index;
+#ifdef _M_X64
+			_BitScanReverse64(&index, x);
+#else
+			if (static_cast<uint32_t>(x >> 32) != 0) {
+				_BitScanReverse(&index, static_cast<uint32_t>(x >> 32));
+				index += 32;
+			}
+			else
+				_BitScanReverse(&index, static_cast<uint32_t>(x));
+#endif
+			return 63 - static_cast<int>(index);
+#else
+			return __builtin_clzll(x);
+#endif
+		}
+
+		//set bits of a group match, Shift converts a bit position into a slot offset
+		template <size_t Width, int Shift>
+		class fhs_bitmask
+		{
+		private:
+			uint64_t mask_;
+
+		public:
+			explicit fhs_bitmask(uint64_t mask) : mask_(mask) {}
+
+			explicit operator bool() const { return mask_ != 0; }
+			size_t lowest() const { return static_cast<size_t>(fhs_ctz(mask_)) >> Shift; }
+			void next() { mask_ &= mask_ - 1; }
+
+			//slots before the first set bit, and after the last one
+			size_t trailing_zeros() const { return mask_ ? lowest() : Width; }
+			size_t leading_zeros() const {
+				return mask_ ? static_cast<size_t>(fhs_clz(mask_) - (64 - (Width << Shift))) >> Shift : Width;
+			}
+		};
+
+#ifdef MINISTL_FHS_SSE2
+		//sixteen control bytes compared at once with SSE2
+		struct fhs_group
+		{
+			static const size_t width = 16;
+			typedef fhs_bitmask<16, 0> mask_type;
+
+			__m128i ctrl;
+
+			explicit fhs_group(const fhs_ctrl* p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+			mask_type match(fhs_ctrl h2) const {
+				return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))));
+			}
+			mask_type match_empty() const {
+				return match(fhs_empty);
+			}
+			mask_type match_empty_or_deleted() const {
+				return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(fhs_sentinel), ctrl))));
+			}
+			size_t count_leading_empty_or_deleted() const {
+				uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(fhs_sentinel), ctrl)));
+				return static_cast<size_t>(fhs_ctz(~static_cast<uint64_t>(mask)));
+			}
+		};
+#else
+		//portable fallback, eight control bytes in a 64 bit word, one flag in the high bit of each byte
+		struct fhs_group
+		{
+			static const size_t width = 8;
+			typedef fhs_bitmask<8, 3> mask_type;
+
+			static const uint64_t lsbs = 0x0101010101010101ULL;
+			static const uint64_t msbs = 0x8080808080808080ULL;
+
+			uint64_t ctrl;
+
+			explicit fhs_group(const fhs_ctrl* p) { std::memcpy(&ctrl, p, sizeof(ctrl)); }
+
+			//may report a false match past a real one, the key compare filters it out
+			mask_type match(fhs_ctrl h2) const {
+				uint64_t x = ctrl ^ (lsbs * static_cast<unsigned char>(h2));
+				return mask_type((x - lsbs) & ~x & msbs);
+			}
+			mask_type match_empty() const {
+				return mask_type(ctrl & (~ctrl << 6) & msbs);
+			}
+			mask_type match_empty_or_deleted() const {
+				return mask_type(ctrl & (~ctrl << 7) & msbs);
+			}
+			size_t count_leading_empty_or_deleted() const {
+				uint64_t full_or_sentinel = ~(ctrl & (~ctrl << 7)) & msbs;
+				return full_or_sentinel ? static_cast<size_t>(fhs_ctz(full_or_sentinel)) >> 3 : width;
+			}
+		};
+#endif
+
+		//control bytes of a table that owns no memory yet, probes see the sentinel and then empties
+		inline fhs_ctrl* fhs_empty_group() {
+			static fhs_ctrl group[fhs_group::width] = {
+				fhs_sentinel, fhs_empty, fhs_empty, fhs_empty, fhs_empty, fhs_empty, fhs_empty, fhs_empty
+#ifdef MINISTL_FHS_SSE2
+				, fhs_empty, fhs_empty, fhs_empty, fhs_empty, fhs_empty, fhs_empty, fhs_empty, fhs_empty
+#endif
+			};
+			return group;
+		}
+
+		//spread the hash so that its low 7 bits and the bucket bits are both well mixed
+		inline size_t fhs_mix(size_t h) {
+			uint64_t x = static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ULL;
+			return static_cast<size_t>(x ^ (x >> 32));
+		}
+
+		//class of iterator
+		template <class Key>
+		struct fhs_iterator : public iterator<forward_iterator_tag, Key>
+		{
+		public:
+			typedef const Key& reference;
+			typedef const Key* pointer;
+
+			const fhs_ctrl* ctrl_;
+			Key* slot_;
+
+		public:
+			fhs_iterator(const fhs_ctrl* ctrl = nullptr, Key* slot = nullptr) : ctrl_(ctrl), slot_(slot) {}
+
+			fhs_iterator& operator++() {
+				++ctrl_;
+				++slot_;
+				skip_empty_or_deleted();
+				return *this;
+			}
+			fhs_iterator operator++(int) { auto res = *this; ++*this; return res; }
+
+			reference operator *() const { return *slot_; }
+			pointer operator ->() const { return slot_; }
+
+			bool operator == (const fhs_iterator& it) const { return ctrl_ == it.ctrl_; }
+			bool operator != (const fhs_iterator& it) const { return ctrl_ != it.ctrl_; }
+
+			//stops on a full slot or on the sentinel that ends the table
+			void skip_empty_or_deleted() {
+				while (*ctrl_ < fhs_sentinel) {
+					size_t shift = fhs_group(ctrl_).count_leading_empty_or_deleted();
+					ctrl_ += shift;
+					slot_ += shift;
+				}
+			}
+		};
+	}
+	//end of Detail
+
+	/*
+	 * flat_hash_set
+	 * open addressing over one slot array plus a parallel array of control bytes.
+	 * a lookup hashes once, takes the high bits as the start of a probe over groups
+	 * of control bytes and the low 7 bits as a tag compared against a whole group in
+	 * one instruction, so only slots whose tag matches are ever touched.
+	 * the table holds 2^k - 1 slots and grows at 7/8 load, erase leaves a tombstone
+	 * only when a probe may have passed over the slot.
+	 * iterators and references are invalidated by any insert that grows the table.
+	 */
+	template <class Key, class Hash = std::hash<Key>, class EqualKey = miniSTL::equal_to<Key>>
+	class flat_hash_set
+	{
+	private:
+		typedef Detail::fhs_ctrl ctrl_type;
+		typedef Detail::fhs_group group_type;
+		typedef allocator<ctrl_type> ctrlAllocator;
+		typedef allocator<Key> slotAllocator;
+
+	public:
+		typedef Key key_type;
+		typedef Key value_type;
+		typedef size_t size_type;
+		typedef Hash hasher;
+		typedef EqualKey key_equal;
+		typedef const value_type& reference;
+		typedef const value_type& const_reference;
+		typedef Detail::fhs_iterator<Key> iterator;
+		typedef Detail::fhs_iterator<Key> const_iterator;
+
+	private:
+		ctrl_type* ctrl_;
+		Key* slots_;
+		size_type capacity_;
+		size_type size_;
+		size_type growth_left_;
+		hasher hash_;
+		key_equal equal_;
+
+	public:
+		explicit flat_hash_set(size_type bucket_count = 0, const hasher& hash = hasher(), const key_equal& equal = key_equal());
+
+		template <class InputIterator>
+		flat_hash_set(InputIterator first, InputIterator last);
+
+		flat_hash_set(const flat_hash_set& s);
+		flat_hash_set(flat_hash_set&& s);
+		flat_hash_set& operator = (const flat_hash_set& s);
+		flat_hash_set& operator = (flat_hash_set&& s);
+		~flat_hash_set();
+
+		size_type size() const { return size_; }
+		bool empty() const { return size_ == 0; }
+
+		//number of slots, every slot is its own bucket
+		size_type bucket_count() const { return capacity_; }
+		float load_factor() const { return capacity_ ? (float)size_ / (float)capacity_ : 0.0f; }
+		//the load the table grows at, 7/8 once it is large, more for the smallest tables
+		float max_load_factor() const {
+			return capacity_ ? (float)capacity_to_growth(capacity_) / (float)capacity_ : 0.875f;
+		}
+
+		void rehash(size_type n);
+		void reserve(size_type n);
+
+		iterator begin() const;
+		iterator end() const { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+
+		iterator find(const key_type& key) const;
+		size_type count(const key_type& key) const { return find(key) == end() ? 0 : 1; }
+
+		miniSTL::pair<iterator, bool> insert(const value_type& val);
+		miniSTL::pair<iterator, bool> insert(value_type&& val);
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last);
+
+		iterator erase(iterator position);
+		size_type erase(const key_type& key);
+
+		void clear();
+		void swap(flat_hash_set& s);
+
+		hasher hash_function() const { return hash_; }
+		key_equal key_eq() const { return equal_; }
+
+	private:
+		static size_type normalize_capacity(size_type n);
+		static size_type capacity_to_growth(size_type capacity) { return capacity - capacity / 8; }
+		static size_type growth_to_capacity(size_type growth) { return growth + (growth - 1) / 7; }
+
+		size_type hash_of(const key_type& key) const { return Detail::fhs_mix(hash_(key)); }
+		static size_type h1(size_type hash) { return hash >> 7; }
+		static ctrl_type h2(size_type hash) { return static_cast<ctrl_type>(hash & 0x7F); }
+
+		void set_ctrl(size_type i, ctrl_type h);
+		void initialize(size_type capacity);
+		void destroy_slots();
+		void resize(size_type new_capacity);
+		void grow_or_purge();
+		void reset_growth_left() { growth_left_ = capacity_to_growth(capacity_) - size_; }
+
+		size_type find_index(const key_type& key, size_type hash) const;
+		size_type find_insert_slot(size_type hash) const;
+		size_type prepare_insert(size_type hash);
+		void commit_insert(size_type i, size_type hash);
+
+		template <class V>
+		miniSTL::pair<iterator, bool> insert_aux(V&& val);
+
+		iterator iterator_at(size_type i) const { return iterator(ctrl_ + i, slots_ + i); }
+		void erase_at(size_type i);
+
+	public:
+		template <class K, class H, class E>
+		friend void swap(flat_hash_set<K, H, E>& lhs, flat_hash_set<K, H, E>& rhs);
+	};
+}
+
+#include "Detail\Flat_hash_set.impl.h"
+#endif // _FLAT_HASH_SET_H_
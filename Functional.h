@@ -10,7 +10,7 @@ namespace miniSTL
 		typedef T second_argument_type;
 		typedef bool result_type;
 
-		result_type operator()(const first_argument_type& x, const first_argument_type& y) {
+		result_type operator()(const first_argument_type& x, const first_argument_type& y) const {
 			return x < y;
 		}
 	};
@@ -22,7 +22,7 @@ namespace miniSTL
 		typedef T second_argument_type;
 		typedef bool result_type;
 
-		result_type operator()(const first_argument_type& x, const first_argument_type& y) {
+		result_type operator()(const first_argument_type& x, const first_argument_type& y) const {
 			return x == y;
 		}
 	};
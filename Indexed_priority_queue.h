@@ -0,0 +1,121 @@
+#ifndef _INDEXED_PRIORITY_QUEUE_H_
+#define _INDEXED_PRIORITY_QUEUE_H_
+
+#include "Algorithm.h"
+#include "Functional.h"
+#include "Vector.h"
+
+namespace miniSTL
+{
+	namespace Detail
+	{
+		//names one push: the slot it was given and how often that slot had been freed before,
+		//so a handle whose element is gone never matches the element that reuses its slot
+		struct ipq_handle {
+			size_t slot;
+			size_t generation;
+
+			bool operator == (const ipq_handle& h) const { return slot == h.slot && generation == h.generation; }
+			bool operator != (const ipq_handle& h) const { return !(*this == h); }
+		};
+	}
+	//end of Detail
+
+	/*
+	 * indexed_priority_queue
+	 * a priority_queue whose push returns a handle to the element, so its priority can be
+	 * changed or the element removed while it is queued, all in O(log n):
+	 * no stale duplicates pile up the way they do when a plain queue emulates decrease-key.
+	 * the heap keeps the elements themselves, as priority_queue does, and a slot table maps
+	 * each handle to the heap position of its element. the heap helpers of Algorithm.h
+	 * report every element they move, which is how the positions stay current.
+	 * a handle is valid from push until its element is popped or erased, after that
+	 * contains() is false for it, other calls taking it must not be made.
+	 */
+	template <class T, class Compare = miniSTL::less<T>, class HeapPolicy = miniSTL::binary_heap_policy>
+	class indexed_priority_queue
+	{
+	public:
+		typedef T value_type;
+		typedef const T& const_reference;
+		typedef size_t size_type;
+		typedef Compare value_compare;
+		typedef HeapPolicy heap_policy;
+		typedef Detail::ipq_handle handle_type;
+
+	private:
+		struct entry {
+			T value;
+			size_type slot;
+		};
+		//pos is npos while the slot is free
+		struct slot_info {
+			size_type pos;
+			size_type generation;
+		};
+		struct entry_compare {
+			Compare comp;
+			bool operator()(const entry& a, const entry& b) const { return comp(a.value, b.value); }
+		};
+		//keeps slots_ current as the heap helpers move entries
+		struct track {
+			slot_info* slots;
+			void operator()(const entry& e, size_type pos) const { slots[e.slot].pos = pos; }
+		};
+
+		static const size_type npos = static_cast<size_type>(-1);
+
+		miniSTL::vector<entry> heap_;
+		miniSTL::vector<slot_info> slots_;
+		miniSTL::vector<size_type> free_;
+		Compare compare_;
+
+	public:
+		explicit indexed_priority_queue(const Compare& comp = Compare()) : compare_(comp) {}
+
+		bool empty() const { return heap_.empty(); }
+		size_type size() const { return static_cast<size_type>(heap_.size()); }
+
+		const_reference top() const { return heap_[0].value; }
+		handle_type top_handle() const { return handleOf(0); }
+
+		handle_type push(const value_type& val);
+		void pop() { eraseAt(0); }
+
+		bool contains(handle_type h) const {
+			return h.slot < static_cast<size_type>(slots_.size()) && slots_[h.slot].generation == h.generation
+				&& slots_[h.slot].pos != npos;
+		}
+		//the element h names, h must be contained
+		const_reference get(handle_type h) const { return heap_[slots_[h.slot].pos].value; }
+		//replaces the element h names and moves it up or down to its new place, h stays valid
+		void update(handle_type h, const value_type& val);
+		void erase(handle_type h) { eraseAt(slots_[h.slot].pos); }
+
+		//reserves room for n elements, so pushes up to n reallocate nothing
+		void reserve(size_type n);
+		//invalidates every handle
+		void clear();
+		void swap(indexed_priority_queue& x);
+
+	private:
+		handle_type handleOf(size_type pos) const;
+		track tracker() { track t = { &slots_[0] }; return t; }
+		entry_compare entryCompare() const { entry_compare c = { compare_ }; return c; }
+		void eraseAt(size_type pos);
+		//moves the entry at pos up, or down when it cannot rise
+		void resift(size_type pos);
+
+	public:
+		template <class T, class Compare, class HeapPolicy>
+		friend void swap(indexed_priority_queue<T, Compare, HeapPolicy>& x, indexed_priority_queue<T, Compare, HeapPolicy>& y);
+	};
+
+	template <class T, class Compare, class HeapPolicy>
+	void swap(indexed_priority_queue<T, Compare, HeapPolicy>& x, indexed_priority_queue<T, Compare, HeapPolicy>& y) {
+		x.swap(y);
+	}
+}
+
+#include "Detail\Indexed_priority_queue.impl.h"
+#endif
@@ -0,0 +1,193 @@
+#ifndef _INTRUSIVE_LIST_H_
+#define _INTRUSIVE_LIST_H_
+
+#include "Functional.h"
+#include "Iterator.h"
+#include "List.h"
+#include "Utility.h"
+
+namespace miniSTL
+{
+	/*
+	 * the hook a type embeds (by deriving from it) to live in an intrusive_list,
+	 * derive once per Tag to be a member of several lists at the same time
+	 */
+	template <class Tag = void>
+	struct intrusive_list_hook : public Detail::list_node_base
+	{
+		intrusive_list_hook() { prev = next = nullptr; }
+		intrusive_list_hook(const intrusive_list_hook&) { prev = next = nullptr; }
+		intrusive_list_hook& operator = (const intrusive_list_hook&) { return *this; }
+
+		bool is_linked() const { return next != nullptr; }
+	};
+
+	namespace Detail
+	{
+		//class of iterator
+		template <class T, class Tag, class Ref, class Ptr>
+		struct ilist_iterator : public iterator<bidirectional_iterator_tag, T>
+		{
+		public:
+			typedef Ref reference;
+			typedef Ptr pointer;
+
+			list_node_base* p;
+
+		public:
+			ilist_iterator(list_node_base* ptr = nullptr) : p(ptr) {}
+			ilist_iterator(const ilist_iterator<T, Tag, T&, T*>& it) : p(it.p) {}
+
+			ilist_iterator& operator++() { p = p->next; return *this; }
+			ilist_iterator operator++(int) { auto res = *this; p = p->next; return res; }
+			ilist_iterator& operator--() { p = p->prev; return *this; }
+			ilist_iterator operator--(int) { auto res = *this; p = p->prev; return res; }
+
+			reference operator *() const { return static_cast<reference>(static_cast<intrusive_list_hook<Tag>&>(*p)); }
+			pointer operator ->() const { return &operator*(); }
+
+			bool operator == (const ilist_iterator& it) const { return p == it.p; }
+			bool operator != (const ilist_iterator& it) const { return p != it.p; }
+		};
+
+		//orders two hooks by the objects that embed them
+		template <class T, class Tag, class Compare>
+		struct ilist_node_compare {
+			Compare comp;
+
+			explicit ilist_node_compare(const Compare& c) : comp(c) {}
+			bool operator()(list_node_base* lhs, list_node_base* rhs) {
+				return comp(static_cast<T&>(static_cast<intrusive_list_hook<Tag>&>(*lhs)),
+					static_cast<T&>(static_cast<intrusive_list_hook<Tag>&>(*rhs)));
+			}
+		};
+	}
+	//end of Detail
+
+	/*
+	 * intrusive_list
+	 * links objects the user already owns through their embedded intrusive_list_hook<Tag>,
+	 * the list never allocates, copies or destroys an element, it only relinks hooks.
+	 * sort and merge run the same node algorithms as list.
+	 */
+	template <class T, class Tag = void>
+	class intrusive_list
+	{
+	private:
+		typedef Detail::list_node_base node_base;
+		typedef intrusive_list_hook<Tag> hook_type;
+
+	public:
+		typedef T value_type;
+		typedef Detail::ilist_iterator<T, Tag, T&, T*> iterator;
+		typedef Detail::ilist_iterator<T, Tag, const T&, const T*> const_iterator;
+		typedef T& reference;
+		typedef const T& const_reference;
+		typedef size_t size_type;
+
+	private:
+		node_base header_;
+		size_type size_;
+
+	public:
+		intrusive_list();
+		intrusive_list(intrusive_list&& l);
+		intrusive_list& operator = (intrusive_list&& l);
+		~intrusive_list();
+
+		intrusive_list(const intrusive_list&) = delete;
+		intrusive_list& operator = (const intrusive_list&) = delete;
+
+		bool empty() const { return size_ == 0; }
+		size_type size() const { return size_; }
+
+		reference front() { return *begin(); }
+		reference back() { return *(--end()); }
+		const_reference front() const { return *begin(); }
+		const_reference back() const { return *(--end()); }
+
+		void push_front(reference val);
+		void pop_front();
+
+		void push_back(reference val);
+		void pop_back();
+
+		iterator begin() { return iterator(header_.next); }
+		iterator end() { return iterator(&header_); }
+		const_iterator begin() const { return const_iterator(header_.next); }
+		const_iterator end() const { return const_iterator(const_cast<node_base*>(&header_)); }
+
+		//O(1), val must currently be linked into this list
+		iterator iterator_to(reference val);
+
+		iterator insert(iterator position, reference val);
+
+		template<class InputIterator>
+		void insert(iterator position, InputIterator first, InputIterator last);
+
+		iterator erase(iterator position);
+		iterator erase(iterator first, iterator last);
+
+		//unlink and hand the element back to its owner
+		template <class Disposer>
+		iterator erase_and_dispose(iterator position, Disposer disposer);
+
+		void swap(intrusive_list& l);
+		void clear();
+
+		template <class Disposer>
+		void clear_and_dispose(Disposer disposer);
+
+		void splice(iterator position, intrusive_list& l);
+		void splice(iterator position, intrusive_list& l, iterator i);
+		void splice(iterator position, intrusive_list& l, iterator first, iterator last);
+
+		void remove(const value_type& val);
+
+		template<class Predicate>
+		void remove_if(Predicate pred);
+
+		template<class Predicate, class Disposer>
+		void remove_and_dispose_if(Predicate pred, Disposer disposer);
+
+		void unique();
+
+		template <class BinaryPredicate>
+		void unique(BinaryPredicate binary_pred);
+
+		template <class BinaryPredicate, class Disposer>
+		void unique_and_dispose(BinaryPredicate binary_pred, Disposer disposer);
+
+		void merge(intrusive_list& l);
+
+		template <class Compare>
+		void merge(intrusive_list& l, Compare comp);
+
+		void sort();
+
+		template <class Compare>
+		void sort(Compare comp);
+
+		void reverse();
+
+	private:
+		static node_base* toNode(reference val) { return static_cast<hook_type*>(&val); }
+		static reference toValue(node_base* p) { return static_cast<reference>(static_cast<hook_type&>(*p)); }
+
+		void init();
+		void linkBefore(node_base* position, node_base* p);
+		void unlink(node_base* p);
+		void fixHeader();
+		void transfer(node_base* position, node_base* first, node_base* last);
+
+		node_base* unlinkAll();
+		void linkAll(node_base* first);
+
+	public:
+		template <class U, class UTag>
+		friend void swap(intrusive_list<U, UTag>& x, intrusive_list<U, UTag>& y);
+	};
+}
+
+#include "Detail\Intrusive_list.impl.h"
+#endif // _INTRUSIVE_LIST_H_
@@ -2,10 +2,12 @@
 #define _LIST_H_
 
 #include "Allocator.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "UninitializedFunctions.h"
 #include "Utility.h"
 #include <type_traits>
+#include <utility>
 
 namespace miniSTL
 {
@@ -14,74 +16,125 @@ namespace miniSTL
 
 	namespace Detail 
 	{
+		//links only, the list header and the intrusive hooks are one of these
+		struct list_node_base {
+			list_node_base* prev;
+			list_node_base* next;
+		};
+
 		//class of Node
 		template <class T>
-		struct Node {
+		struct Node : public list_node_base {
 			T data;
-			Node* prev;
-			Node* next;
-
-			Node(const T& d, Node* p, Node* n) :
-				data(d), prev(p), next(n) {}
 
-			bool operator == (const Node& n){
-				return data == n.data && prev == n.prev &&
-					next == n.next;
+			template <class... Args>
+			Node(list_node_base* p, list_node_base* n, Args&&... args) :
+				data(std::forward<Args>(args)...) {
+				prev = p;
+				next = n;
 			}
 		};
 
 		//class of iterator
-		template <class T>
+		template <class T, class Ref = T&, class Ptr = T*>
 		struct listIterator : public iterator<bidirectional_iterator_tag, T>
 		{
-			template <class T>
-			friend class list;
-
 		public:
 			typedef Node<T>* nodeptr;
-			nodeptr p;
+			typedef Ref reference;
+			typedef Ptr pointer;
+			list_node_base* p;
 
 		public:
-			listIterator(nodeptr ptr = nullptr) : p(ptr) {}
+			listIterator(list_node_base* ptr = nullptr) : p(ptr) {}
+			listIterator(const listIterator<T>& it) : p(it.p) {}
 
 			listIterator& operator++();
 			listIterator operator++(int);
 			listIterator& operator--();
 			listIterator operator--(int);
 
-			T& operator *() { return p->data; }
-			T* operator ->() { return &operator*(); }
+			reference operator *() const { return static_cast<nodeptr>(p)->data; }
+			pointer operator ->() const { return &operator*(); }
+
+			bool operator == (const listIterator& it) const { return p == it.p; }
+			bool operator != (const listIterator& it) const { return p != it.p; }
+		};
+
+		//owns a node extracted from a list, it can be inserted into another list without reallocating
+		template <class T>
+		class list_node_handle
+		{
+			template <class U>
+			friend class miniSTL::list;
+
+		private:
+			typedef Node<T>* nodeptr;
+			nodeptr ptr_;
 
-			template <class T>
-			friend bool operator == (const listIterator& lhs, const listIterator& rhs);
+			explicit list_node_handle(nodeptr p) : ptr_(p) {}
+
+		public:
+			typedef T value_type;
 
-			template <class T>
-			friend bool operator != (const listIterator& lhs, const listIterator& rhs);
+			list_node_handle() : ptr_(nullptr) {}
+			list_node_handle(list_node_handle&& nh) : ptr_(nh.ptr_) { nh.ptr_ = nullptr; }
+			list_node_handle& operator = (list_node_handle&& nh);
+			~list_node_handle();
+
+			list_node_handle(const list_node_handle&) = delete;
+			list_node_handle& operator = (const list_node_handle&) = delete;
+
+			bool empty() const { return ptr_ == nullptr; }
+			explicit operator bool() const { return ptr_ != nullptr; }
+			value_type& value() const { return ptr_->data; }
 		};
+
+		//orders two nodes by the values they hold
+		template <class Node, class Compare>
+		struct list_node_compare {
+			Compare comp;
+
+			explicit list_node_compare(const Compare& c) : comp(c) {}
+			bool operator()(const list_node_base* lhs, const list_node_base* rhs) {
+				return comp(static_cast<const Node*>(lhs)->data, static_cast<const Node*>(rhs)->data);
+			}
+		};
+
+		//merge two null-terminated chains linked through next, ties keep lhs first
+		template <class NodePtr, class NodeCompare>
+		NodePtr list_merge_chains(NodePtr lhs, NodePtr rhs, NodeCompare& comp);
+
+		//bottom-up merge sort of a null-terminated chain, only next is maintained
+		template <class NodePtr, class NodeCompare>
+		NodePtr list_sort_chain(NodePtr first, NodeCompare& comp);
 	}
 	//end of Detail
 
-	//class of list
+	/*
+	 * list
+	 * circular doubly linked list around a data-less header node, end() is the header,
+	 * so linking and unlinking never branch on the first or last element and T needs no default constructor
+	 */
 	template <class T>
 	class list 
 	{
-		template <class T>
-		friend struct listIterator;
-
 	private:
 		typedef allocator<Detail::Node<T>> nodeAllocator;
 		typedef Detail::Node<T>* nodeptr;
+		typedef Detail::list_node_base node_base;
 
 	public:
 		typedef T value_type;
 		typedef Detail::listIterator<T> iterator;
-		typedef Detail::listIterator<const T> const_iterator;
+		typedef Detail::listIterator<T, const T&, const T*> const_iterator;
 		typedef T& reference;
+		typedef const T& const_reference;
 		typedef size_t size_type;
+		typedef Detail::list_node_handle<T> node_type;
 
 	private:
-		iterator head;
-		iterator tail;
+		node_base header_;
 
 	public:
 		list();
@@ -91,27 +144,48 @@ namespace miniSTL
 		list(InputIterator first, InputIterator last);
 
 		list(const list& l);
+		list(list&& l);
 		list& operator = (const list& l);
+		list& operator = (list&& l);
 		~list();
 
-		bool empty() const { return head == tail; }
+		void assign(size_type n, const value_type& val);
+
+		template<class InputIterator>
+		void assign(InputIterator first, InputIterator last);
+
+		bool empty() const { return header_.next == &header_; }
 		size_t size() const;
 
-		reference front() { return head.p->data; }
-		reference back() { return tail.p->prev->data; }
+		reference front() { return static_cast<nodeptr>(header_.next)->data; }
+		reference back() { return static_cast<nodeptr>(header_.prev)->data; }
+		const_reference front() const { return static_cast<const Detail::Node<T>*>(header_.next)->data; }
+		const_reference back() const { return static_cast<const Detail::Node<T>*>(header_.prev)->data; }
 
 		void push_front(const value_type& val);
+		void push_front(value_type&& val);
 		void pop_front();
 
 		void push_back(const value_type& val);
+		void push_back(value_type&& val);
 		void pop_back();
 
+		template <class... Args>
+		void emplace_front(Args&&... args);
+
+		template <class... Args>
+		void emplace_back(Args&&... args);
+
+		template <class... Args>
+		iterator emplace(iterator position, Args&&... args);
+
 		iterator begin();
 		iterator end();
 		const_iterator begin() const;
 		const_iterator end() const;
 
 		iterator insert(iterator position, const value_type& val);
+		iterator insert(iterator position, value_type&& val);
 		void insert(iterator position, size_t n, const value_type& val);
 
 		template<class InputIterator>
@@ -120,6 +194,10 @@ namespace miniSTL
 		iterator erase(iterator position);
 		iterator erase(iterator first, iterator last);
 
+		//unlink a node without destroying it, and link an extracted node back in
+		node_type extract(iterator position);
+		iterator insert(iterator position, node_type&& nh);
+
 		void swap(list& l);
 		void clear();
 
@@ -145,23 +223,37 @@ namespace miniSTL
 		void sort();
 
 		template <class Compare>
-		void sort(list& l, Compare comp);
+		void sort(Compare comp);
 
 		void reverse();
 
 	private:
+		void init();
 		void ctorAux(size_type n, const value_type& val, std::true_type);
 
 		template <class InputIterator>
 		void ctorAux(InputIterator first, InputIterator last, std::false_type);
 
-		nodeptr newNode(const T& val = T());
+		template <class... Args>
+		nodeptr newNode(Args&&... args);
 		void deleteNode(nodeptr ptr);
+		void linkBefore(node_base* position, node_base* node);
+		void unlinkNode(node_base* node);
+		void transfer(node_base* position, node_base* first, node_base* last);
+		void fixHeader();
+
+		node_base* unlinkAll();
+		void linkAll(node_base* first);
 
 		void insert_aux(iterator position, size_type n, const T& val, std::true_type);
 
 		template <class InputIterator>
 		void insert_aux(iterator position, InputIterator first, InputIterator last, std::false_type);
+
+		void assign_aux(size_type n, const value_type& val, std::true_type);
+
+		template <class InputIterator>
+		void assign_aux(InputIterator first, InputIterator last, std::false_type);
 	
 	public:
 		template <class T>
@@ -0,0 +1,36 @@
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstddef>
+
+namespace miniSTL
+{
+	/*
+	 * Mapped_file
+	 * a whole file mapped read-only into memory, mmap on POSIX and MapViewOfFile on Windows.
+	 * pages are loaded on first touch, so opening costs the same for any file size.
+	 * is_open() is false when the file is missing, empty or cannot be mapped.
+	 */
+	class Mapped_file
+	{
+	private:
+		const void* data_;
+		size_t size_;
+#ifdef _WIN32
+		void* file_;
+		void* mapping_;
+#endif
+
+	public:
+		explicit Mapped_file(const char* path);
+		Mapped_file(const Mapped_file&) = delete;
+		Mapped_file& operator = (const Mapped_file&) = delete;
+		~Mapped_file();
+
+		bool is_open()const { return data_ != nullptr; }
+		const void* data()const { return data_; }
+		size_t size()const { return size_; }
+	};
+}
+
+#endif
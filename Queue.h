@@ -1,6 +1,7 @@
 #ifndef _QUEUE_H_
 #define _QUEUE_H_
 
+#include "Algorithm.h"
 #include "Deque.h"
 #include "Functional.h"
 #include "Vector.h"
@@ -63,12 +64,20 @@ namespace miniSTL
 		miniSTL::swap(x.container_, y.container_);
 	}
 
-	template <class T, class Container = miniSTL::vector<T>, class Compare = miniSTL::less<T>>
+	/*
+	 * priority_queue
+	 * HeapPolicy sets the arity of the heap kept in the container, see dary_heap_policy in Algorithm.h.
+	 * a 4-ary heap pays off for large queues of small elements, where pop is bound by the misses
+	 * of a deep binary heap rather than by comparisons
+	 */
+	template <class T, class Container = miniSTL::vector<T>, class Compare = miniSTL::less<T>,
+	class HeapPolicy = miniSTL::binary_heap_policy>
 	class priority_queue
 	{
 	public:
 		typedef T value_type;
 		typedef Container container_type;
+		typedef HeapPolicy heap_policy;
 		typedef typename Container::reference reference;
 		typedef typename Container::const_reference const_reference;
 		typedef typename Container::size_type size_type;
@@ -88,7 +97,7 @@ namespace miniSTL
 			const Container& ctnr = Container())
 			: container_(ctnr), compare_(comp) {
 			container_.insert(container_.end(), first, last);
-			miniSTL::make_heap(container_.begin(), container_.end());
+			miniSTL::make_heap(container_.begin(), container_.end(), compare_, HeapPolicy());
 		}
 
 		bool empty() const {
@@ -105,26 +114,54 @@ namespace miniSTL
 
 		void push(const value_type& val) {
 			container_.push_back(val);
-			miniSTL::push_heap(container_.begin(), container_.end(), compare_);
+			miniSTL::push_heap(container_.begin(), container_.end(), compare_, HeapPolicy());
 		}
 
 		void pop() {
-			miniSTL::pop_heap(container_.begin(), container_.end(), compare_);
+			miniSTL::pop_heap(container_.begin(), container_.end(), compare_, HeapPolicy());
 			container_.pop_back();
 		}
 
+		//appends [first, last) and restores the heap with whichever costs less: sifting up each
+		//new element, O(m log n), or heapifying the whole container, O(n + m). sift-ups on random
+		//keys rarely climb far, so the rebuild only wins once the batch outgrows the queue
+		template <class InputIterator>
+		void push_range(InputIterator first, InputIterator last) {
+			const size_type old = size();
+			container_.insert(container_.end(), first, last);
+			const size_type len = size();
+			if (len - old > old) {
+				miniSTL::make_heap(container_.begin(), container_.end(), compare_, HeapPolicy());
+				return;
+			}
+			for (size_type i = old; i != len; ++i)
+				miniSTL::push_heap(container_.begin(), container_.begin() + (i + 1), compare_, HeapPolicy());
+		}
+
+		//moves the top k elements, or all when there are fewer, to out in pop order
+		template <class OutputIterator>
+		OutputIterator pop_n(size_type k, OutputIterator out) {
+			for (size_type n = size(); k != 0 && n != 0; --k, --n) {
+				miniSTL::pop_heap(container_.begin(), container_.end(), compare_, HeapPolicy());
+				*out = std::move(container_.back());
+				++out;
+				container_.pop_back();
+			}
+			return out;
+		}
+
 		void swap(priority_queue& x) {
 			miniSTL::swap(container_, x.container_);
 			miniSTL::swap(compare_, x.compare_);
 		}
 
 	public:
-		template <class T, class Container, class Compare>
-		friend void swap(priority_queue<T, Container, Compare>& x, priority_queue<T, Container, Compare>& y);
+		template <class T, class Container, class Compare, class HeapPolicy>
+		friend void swap(priority_queue<T, Container, Compare, HeapPolicy>& x, priority_queue<T, Container, Compare, HeapPolicy>& y);
 	};
 
-	template <class T, class Container, class Compare>
-	void swap(priority_queue<T, Container, Compare>& x, priority_queue<T, Container, Compare>& y) {
+	template <class T, class Container, class Compare, class HeapPolicy>
+	void swap(priority_queue<T, Container, Compare, HeapPolicy>& x, priority_queue<T, Container, Compare, HeapPolicy>& y) {
 		x.swap(y);
 	}
 }
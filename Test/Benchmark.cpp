@@ -0,0 +1,575 @@
+#include "Benchmark.h"
+
+#include "../Concurrent_priority_queue.h"
+#include "../Concurrent_unordered_set.h"
+#include "../Indexed_priority_queue.h"
+#include "../Queue.h"
+#include "../Unordered_map.h"
+#include "../Unordered_set.h"
+#include "../Unordered_set_image.h"
+
+#include <unordered_map>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace miniSTL {
+	namespace Benchmark {
+		//sink for lookup results so the loops are not optimized away
+		static size_t found = 0;
+
+		template<class Set, class Key>
+		void benchSet(const std::string& name, const std::vector<Key>& keys, const std::vector<Key>& misses) {
+			Set set(10);
+			report(name, "insert", time_ms([&]() {
+				for (auto& k : keys)
+					set.insert(k);
+			}));
+			report(name, "find hit", time_ms([&]() {
+				for (auto& k : keys)
+					found += set.count(k);
+			}));
+			report(name, "find miss", time_ms([&]() {
+				for (auto& k : misses)
+					found += set.count(k);
+			}));
+			report(name, "erase", time_ms([&]() {
+				for (auto& k : keys)
+					found += set.erase(k);
+			}));
+		}
+
+		//hash % prime against fastmod over the same primes and power of two tables with a mixed hash
+		void bucketPolicies() {
+			const size_t n = 1000000;
+			std::mt19937_64 gen(1);
+			std::vector<size_t> ints(n), intMisses(n);
+			for (size_t i = 0; i != n; ++i) {
+				ints[i] = gen() >> 1;
+				intMisses[i] = ints[i] | (size_t(1) << 63);
+			}
+			std::vector<std::string> strs(n / 5), strMisses(n / 5);
+			for (size_t i = 0; i != n / 5; ++i) {
+				strs[i] = "key" + std::to_string(gen());
+				strMisses[i] = "miss" + std::to_string(gen());
+			}
+
+			typedef std::hash<size_t> IntHash;
+			typedef std::hash<std::string> StrHash;
+			typedef miniSTL::equal_to<size_t> IntEq;
+			typedef miniSTL::equal_to<std::string> StrEq;
+
+			benchSet<Unordered_set<size_t, IntHash, IntEq, allocator<size_t>, prime_bucket_policy>>(
+				"Unordered_set<size_t> prime", ints, intMisses);
+			benchSet<Unordered_set<size_t, IntHash, IntEq, allocator<size_t>, fastmod_bucket_policy>>(
+				"Unordered_set<size_t> fastmod", ints, intMisses);
+			benchSet<Unordered_set<size_t, IntHash, IntEq, allocator<size_t>, pow2_bucket_policy>>(
+				"Unordered_set<size_t> pow2", ints, intMisses);
+
+			benchSet<Unordered_set<std::string, StrHash, StrEq, allocator<std::string>, prime_bucket_policy>>(
+				"Unordered_set<string> prime", strs, strMisses);
+			benchSet<Unordered_set<std::string, StrHash, StrEq, allocator<std::string>, fastmod_bucket_policy>>(
+				"Unordered_set<string> fastmod", strs, strMisses);
+			benchSet<Unordered_set<std::string, StrHash, StrEq, allocator<std::string>, pow2_bucket_policy>>(
+				"Unordered_set<string> pow2", strs, strMisses);
+		}
+
+		//one find per key against count_batch over the same keys, on a set well past the last level cache
+		void batchLookups() {
+			const size_t n = 4000000;
+			std::mt19937_64 gen(2);
+			std::vector<size_t> keys(n), probes(n);
+			for (size_t i = 0; i != n; ++i)
+				keys[i] = gen();
+			for (size_t i = 0; i != n; ++i)
+				probes[i] = (i & 1) ? keys[gen() % n] : gen();
+
+			Unordered_set<size_t> set(n);
+			for (auto k : keys)
+				set.insert(k);
+			const std::string name = "Unordered_set<size_t> 4M";
+			report(name, "count loop", time_ms([&]() {
+				for (auto k : probes)
+					found += set.count(k);
+			}));
+			report(name, "count_batch", time_ms([&]() {
+				found += set.count_batch(probes.begin(), probes.end());
+			}));
+		}
+
+		//growing one insert at a time against the range constructor, which sizes the table once
+		void bulkBuild() {
+			const size_t n = 4000000;
+			std::mt19937_64 gen(3);
+			std::vector<size_t> keys(n);
+			for (auto& k : keys)
+				k = gen();
+
+			const std::string name = "Unordered_set<size_t> 4M";
+			report(name, "insert loop", time_ms([&]() {
+				Unordered_set<size_t> set(10);
+				for (auto k : keys)
+					set.insert(k);
+				found += set.size();
+			}));
+			report(name, "range build", time_ms([&]() {
+				Unordered_set<size_t> set(keys.begin(), keys.end());
+				found += set.size();
+			}));
+		}
+
+		//the map runs the set engine, with the mapped value next to the key in the node
+		void mapVsSet() {
+			const size_t n = 1000000;
+			std::mt19937_64 gen(4);
+			std::vector<size_t> keys(n);
+			for (auto& k : keys)
+				k = gen();
+
+			Unordered_set<size_t> set(10);
+			report("Unordered_set<size_t>", "insert", time_ms([&]() {
+				for (auto k : keys)
+					set.insert(k);
+			}));
+			report("Unordered_set<size_t>", "find hit", time_ms([&]() {
+				for (auto k : keys)
+					found += set.count(k);
+			}));
+
+			Unordered_map<size_t, size_t> map(10);
+			report("Unordered_map<size_t, size_t>", "operator[]", time_ms([&]() {
+				for (auto k : keys)
+					map[k] = k;
+			}));
+			report("Unordered_map<size_t, size_t>", "find hit", time_ms([&]() {
+				for (auto k : keys)
+					found += map.find(k)->second & 1;
+			}));
+
+			std::unordered_map<size_t, size_t> stdMap;
+			report("std::unordered_map<size_t, size_t>", "operator[]", time_ms([&]() {
+				for (auto k : keys)
+					stdMap[k] = k;
+			}));
+			report("std::unordered_map<size_t, size_t>", "find hit", time_ms([&]() {
+				for (auto k : keys)
+					found += stdMap.find(k)->second & 1;
+			}));
+		}
+
+		//a table grown for 4M keys holding 10k, iteration and clear() follow the occupancy bitmap
+		void sparseIteration() {
+			Unordered_set<size_t> set(10);
+			set.reserve(4000000);
+			std::mt19937_64 gen(6);
+			for (auto i = 0; i != 10000; ++i)
+				set.insert(gen());
+
+			const std::string name = "Unordered_set 10k keys/4M buckets";
+			report(name, "100 x iterate", time_ms([&]() {
+				for (auto round = 0; round != 100; ++round) {
+					for (auto k : set)
+						found += k & 1;
+				}
+			}));
+			report(name, "clear", time_ms([&]() {
+				set.clear();
+			}));
+		}
+
+		//each thread runs the same number of lookups, flat times mean the reads scale with the threads
+		template<class Lookup>
+		double parallel_ms(int threads, Lookup lookup) {
+			return time_ms([&]() {
+				std::vector<std::thread> pool;
+				for (auto t = 0; t != threads; ++t)
+					pool.push_back(std::thread(lookup, t));
+				for (auto& th : pool)
+					th.join();
+			});
+		}
+
+		//one mutex around an Unordered_set against 64 reader-writer locked shards
+		void concurrentReads() {
+			const size_t n = 1000000;
+			std::vector<size_t> keys(n);
+			std::mt19937_64 gen(5);
+			for (auto& k : keys)
+				k = gen();
+
+			Unordered_set<size_t> locked(keys.begin(), keys.end());
+			std::mutex mutex;
+			Concurrent_unordered_set<size_t> sharded(64, n);
+			for (auto k : keys)
+				sharded.insert(k);
+
+			std::vector<size_t> hits(64);
+			for (auto threads : { 1, 2, 4, 8 }) {
+				const std::string op = std::to_string(threads) + " threads";
+				report("Unordered_set + mutex, 1M finds", op, parallel_ms(threads, [&](int t) {
+					size_t h = 0;
+					for (size_t i = t; i < n + t; ++i) {
+						std::lock_guard<std::mutex> guard(mutex);
+						h += locked.count(keys[i % n]);
+					}
+					hits[t * 8] = h;
+				}));
+				report("Concurrent_unordered_set, 1M finds", op, parallel_ms(threads, [&](int t) {
+					size_t h = 0;
+					for (size_t i = t; i < n + t; ++i)
+						h += sharded.count(keys[i % n]);
+					hits[t * 8] = h;
+				}));
+				for (auto h : hits)
+					found += h;
+			}
+		}
+
+		//rebuilding a set key by key against opening its image, the image is written once up front
+		void imageLoad() {
+			const size_t n = 4000000;
+			std::mt19937_64 gen(7);
+			std::vector<size_t> keys(n);
+			for (auto& k : keys)
+				k = gen();
+
+			Unordered_set<size_t> set(10);
+			report("Unordered_set 4M keys", "insert", time_ms([&]() {
+				for (auto k : keys)
+					set.insert(k);
+			}));
+			std::ostringstream out;
+			report("Unordered_set_image 4M keys", "write", time_ms([&]() {
+				Unordered_set_image<size_t>::write(out, set);
+			}));
+			const std::string bytes = out.str();
+			std::vector<uint64_t> buf(bytes.size() / sizeof(uint64_t) + 1);
+			memcpy(&buf[0], bytes.data(), bytes.size());
+			report("Unordered_set_image 4M keys", "open", time_ms([&]() {
+				Unordered_set_image<size_t> image(&buf[0], bytes.size());
+				found += image.size();
+			}));
+
+			Unordered_set_image<size_t> image(&buf[0], bytes.size());
+			report("Unordered_set 4M keys", "find hit", time_ms([&]() {
+				for (auto k : keys)
+					found += set.count(k);
+			}));
+			report("Unordered_set_image 4M keys", "find hit", time_ms([&]() {
+				for (auto k : keys)
+					found += image.count(k);
+			}));
+		}
+
+		//90% misses against 4M keys, with and without the Bloom filter in front of the buckets
+		void bloomMisses() {
+			const size_t n = 4000000;
+			std::mt19937_64 gen(8);
+			std::vector<size_t> keys(n), probes(n);
+			for (auto& k : keys)
+				k = gen() >> 1;
+			for (size_t i = 0; i != n; ++i)
+				probes[i] = i % 10 == 0 ? keys[i] : gen() | (size_t(1) << 63);
+
+			Unordered_set<size_t> plain(keys.begin(), keys.end());
+			Unordered_set<size_t> filtered(keys.begin(), keys.end());
+			filtered.bloom_filter(true);
+			report("Unordered_set 4M, 90% misses", "count", time_ms([&]() {
+				for (auto k : probes)
+					found += plain.count(k);
+			}));
+			report("Unordered_set+bloom 4M, 90% misses", "count", time_ms([&]() {
+				for (auto k : probes)
+					found += filtered.count(k);
+			}));
+			report("Unordered_set 4M, 90% misses", "count_batch", time_ms([&]() {
+				found += plain.count_batch(probes.begin(), probes.end());
+			}));
+			report("Unordered_set+bloom 4M, 90% misses", "count_batch", time_ms([&]() {
+				found += filtered.count_batch(probes.begin(), probes.end());
+			}));
+		}
+
+		//two 2M key sets sharing half their keys, the loops over insert/count against the set algebra
+		void setAlgebra() {
+			const size_t n = 2000000;
+			std::mt19937_64 gen(9);
+			std::vector<size_t> keys(n * 3 / 2);
+			for (auto& k : keys)
+				k = gen();
+			Unordered_set<size_t> a(keys.begin(), keys.begin() + n), b(keys.begin() + n / 2, keys.end());
+
+			report("intersect 2M x 2M, loop", "count+insert", time_ms([&]() {
+				Unordered_set<size_t> c(10);
+				for (auto k : a) {
+					if (b.count(k))
+						c.insert(k);
+				}
+				found += c.size();
+			}));
+			for (auto threads : { 1, 4 }) {
+				report("intersect 2M x 2M", std::to_string(threads) + " threads", time_ms([&]() {
+					found += a.intersect(b, threads).size();
+				}));
+			}
+			report("union 2M into 2M, loop", "insert", time_ms([&]() {
+				Unordered_set<size_t> c(a);
+				for (auto k : b)
+					c.insert(k);
+				found += c.size();
+			}));
+			report("union 2M into 2M", "union_into", time_ms([&]() {
+				Unordered_set<size_t> c(a);
+				b.union_into(c);
+				found += c.size();
+			}));
+			Unordered_set<size_t> c(a), d(b);
+			report("merge 2M into 2M", "merge", time_ms([&]() {
+				c.merge(d);
+				found += c.size();
+			}));
+		}
+
+		template<int Arity>
+		void benchHeap(const std::vector<size_t>& keys, size_t rounds) {
+			priority_queue<size_t, vector<size_t>, less<size_t>, dary_heap_policy<Arity>> pq;
+			double push = 0, pop = 0;
+			for (size_t r = 0; r != rounds; ++r) {
+				push += time_ms([&]() {
+					for (auto k : keys)
+						pq.push(k);
+				});
+				pop += time_ms([&]() {
+					while (!pq.empty()) {
+						found += pq.top() & 1;
+						pq.pop();
+					}
+				});
+			}
+			const std::string name = std::to_string(Arity) + "-ary heap, " + std::to_string(rounds) + " x "
+				+ std::to_string(keys.size()) + " keys";
+			report(name, "push", push);
+			report(name, "pop", pop);
+		}
+
+		//a small queue that stays in cache, where comparisons dominate, and one that does not
+		void heapArity() {
+			std::mt19937_64 gen(10);
+			std::vector<size_t> small(1000), large(4000000);
+			for (auto& k : small)
+				k = gen();
+			for (auto& k : large)
+				k = gen();
+			benchHeap<2>(small, 1000);
+			benchHeap<4>(small, 1000);
+			benchHeap<8>(small, 1000);
+			benchHeap<2>(large, 1);
+			benchHeap<4>(large, 1);
+			benchHeap<8>(large, 1);
+		}
+
+		//string keys with a long shared prefix, each comparison walks it, so pop is bound by
+		//the number of comparisons rather than by memory
+		void heapCompare() {
+			std::mt19937_64 gen(12);
+			std::vector<std::string> keys(200000);
+			for (auto& k : keys)
+				k = std::string(48, 'k') + std::to_string(gen());
+			priority_queue<std::string> pq;
+			report("string heap, 200000 keys", "push", time_ms([&]() {
+				for (auto& k : keys)
+					pq.push(k);
+			}));
+			report("string heap, 200000 keys", "pop", time_ms([&]() {
+				while (!pq.empty()) {
+					found += pq.top().size();
+					pq.pop();
+				}
+			}));
+		}
+
+		//batches merged into a queue every tick, small against the queue and then one larger than it
+		void batchPush() {
+			std::mt19937_64 gen(13);
+			std::vector<size_t> queued(1000000), batch(2000000);
+			for (auto& k : queued)
+				k = gen();
+			for (auto& k : batch)
+				k = gen();
+			for (size_t size : { static_cast<size_t>(10000), batch.size() }) {
+				priority_queue<size_t> pq1(queued.data(), queued.data() + queued.size());
+				priority_queue<size_t> pq2(pq1);
+				const size_t ticks = batch.size() / size;
+				const std::string name = std::to_string(ticks) + " x " + std::to_string(size) + " onto 1000000";
+				report(name, "push", time_ms([&]() {
+					for (size_t i = 0; i != batch.size(); ++i)
+						pq1.push(batch[i]);
+				}));
+				report(name, "push_range", time_ms([&]() {
+					for (size_t t = 0; t != ticks; ++t)
+						pq2.push_range(batch.data() + t * size, batch.data() + (t + 1) * size);
+				}));
+				found += pq1.top() == pq2.top();
+			}
+		}
+
+		//one mutex around a priority_queue against the MultiQueue, relaxed and strict. every
+		//thread alternates push and pop on a queue preloaded with 100k keys, the relaxed run
+		//samples its rank error on the side
+		void concurrentHeap() {
+			const size_t preload = 100000, ops = 400000;
+			std::mt19937_64 gen(14);
+			std::vector<size_t> keys(preload + ops);
+			for (auto& k : keys)
+				k = gen();
+
+			std::vector<size_t> sums(64);
+			for (auto threads : { 1, 2, 4, 8 }) {
+				const std::string op = std::to_string(threads) + " threads";
+				const size_t per = ops / threads;
+
+				priority_queue<size_t> locked(keys.data(), keys.data() + preload);
+				std::mutex mutex;
+				report("priority_queue + mutex, 400k", op, parallel_ms(threads, [&](int t) {
+					size_t sum = 0;
+					for (size_t i = preload + t * per; i != preload + (t + 1) * per; ++i) {
+						std::lock_guard<std::mutex> guard(mutex);
+						locked.push(keys[i]);
+						sum += locked.top();
+						locked.pop();
+					}
+					sums[t * 8] = sum;
+				}));
+
+				for (auto strict : { false, true }) {
+					Concurrent_priority_queue<size_t> multi(2 * threads);
+					multi.set_strict(strict);
+					for (size_t i = 0; i != preload; ++i)
+						multi.push(keys[i]);
+					const std::string name = strict ? "MultiQueue strict" : "MultiQueue relaxed";
+					report(name + ", 400k", op, parallel_ms(threads, [&](int t) {
+						size_t sum = 0, x;
+						for (size_t i = preload + t * per; i != preload + (t + 1) * per; ++i) {
+							multi.push(keys[i]);
+							if (multi.try_pop(x))
+								sum += x;
+						}
+						sums[t * 8] = sum;
+					}));
+					if (strict)
+						continue;
+					multi.sample_rank_error(100);
+					parallel_ms(threads, [&](int t) {
+						size_t x;
+						for (size_t i = preload + t * per; i != preload + (t + 1) * per; ++i) {
+							multi.push(keys[i]);
+							multi.try_pop(x);
+						}
+					});
+					const rank_error_stats stats = multi.rank_error();
+					std::cout << "  rank error over " << stats.samples << " samples: mean " << stats.mean()
+						<< ", max " << stats.max << std::endl;
+				}
+				for (auto sum : sums)
+					found += sum;
+			}
+		}
+
+		//Dijkstra over a random graph: a plain queue pushes a duplicate on every shorter path
+		//and skips stale entries as they surface, the indexed one updates the queued entry
+		void benchDijkstra(uint32_t vertices, uint32_t degree) {
+			typedef std::pair<uint64_t, uint32_t> item;
+			std::mt19937 gen(11);
+			std::vector<uint32_t> to(vertices * degree);
+			std::vector<uint32_t> weight(vertices * degree);
+			for (size_t e = 0; e != to.size(); ++e) {
+				to[e] = gen() % vertices;
+				weight[e] = gen() % 1000 + 1;
+			}
+			const uint64_t unreached = static_cast<uint64_t>(-1);
+
+			std::vector<uint64_t> dist(vertices, unreached);
+			size_t peak = 0;
+			double lazy = time_ms([&]() {
+				priority_queue<item, vector<item>, std::greater<item>> pq;
+				dist[0] = 0;
+				pq.push(item(0, 0));
+				while (!pq.empty()) {
+					const item top = pq.top();
+					pq.pop();
+					if (top.first != dist[top.second])
+						continue;
+					for (uint32_t e = top.second * degree; e != (top.second + 1) * degree; ++e) {
+						const uint64_t d = top.first + weight[e];
+						if (d < dist[to[e]]) {
+							dist[to[e]] = d;
+							pq.push(item(d, to[e]));
+						}
+					}
+					peak = pq.size() > peak ? pq.size() : peak;
+				}
+			});
+			const std::string graph = std::to_string(vertices) + " x " + std::to_string(degree) + ", ";
+			report(graph + "lazy, peak " + std::to_string(peak), "dijkstra", lazy);
+			found += static_cast<size_t>(dist[vertices - 1]);
+
+			typedef indexed_priority_queue<item, std::greater<item>> queue;
+			std::vector<uint64_t> dist2(vertices, unreached);
+			std::vector<queue::handle_type> handles(vertices);
+			peak = 0;
+			double indexed = time_ms([&]() {
+				queue pq;
+				dist2[0] = 0;
+				handles[0] = pq.push(item(0, 0));
+				while (!pq.empty()) {
+					const item top = pq.top();
+					pq.pop();
+					for (uint32_t e = top.second * degree; e != (top.second + 1) * degree; ++e) {
+						const uint64_t d = top.first + weight[e];
+						const uint32_t v = to[e];
+						if (d < dist2[v]) {
+							if (dist2[v] == unreached)
+								handles[v] = pq.push(item(d, v));
+							else
+								pq.update(handles[v], item(d, v));
+							dist2[v] = d;
+						}
+					}
+					peak = pq.size() > peak ? pq.size() : peak;
+				}
+			});
+			report(graph + "indexed, peak " + std::to_string(peak), "dijkstra", indexed);
+			found += dist == dist2;
+		}
+
+		//the denser graph finds more shorter paths per vertex, so more duplicates for the plain queue
+		void decreaseKey() {
+			benchDijkstra(200000, 8);
+			benchDijkstra(50000, 32);
+		}
+
+		void runAll() {
+			bucketPolicies();
+			batchLookups();
+			bulkBuild();
+			mapVsSet();
+			sparseIteration();
+			concurrentReads();
+			imageLoad();
+			bloomMisses();
+			setAlgebra();
+			heapArity();
+			heapCompare();
+			batchPush();
+			decreaseKey();
+			concurrentHeap();
+			std::cout << "(" << found << ")" << std::endl;
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace miniSTL {
+	//timings, built into main only with MINISTL_BENCHMARK defined, run them in a release build
+	namespace Benchmark {
+		//wall time of f() in milliseconds
+		template<class Func>
+		double time_ms(Func f) {
+			auto start = std::chrono::steady_clock::now();
+			f();
+			auto stop = std::chrono::steady_clock::now();
+			return std::chrono::duration<double, std::milli>(stop - start).count();
+		}
+
+		inline void report(const std::string& name, const std::string& op, double ms) {
+			std::cout << std::left << std::setw(36) << name << std::setw(12) << op
+				<< std::right << std::fixed << std::setprecision(2) << std::setw(10) << ms << " ms" << std::endl;
+		}
+
+		void bucketPolicies();
+		void batchLookups();
+		void bulkBuild();
+		void mapVsSet();
+		void sparseIteration();
+		void concurrentReads();
+		void imageLoad();
+		void bloomMisses();
+		void setAlgebra();
+		void heapArity();
+		void heapCompare();
+		void batchPush();
+		void decreaseKey();
+		void concurrentHeap();
+
+		void runAll();
+	}
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include "Concurrent_priority_queueTest.h"
+
+namespace miniSTL {
+	namespace Concurrent_priority_queueTest {
+		//strict pops come out in exact order
+		void testCase1() {
+			tsCpq<int> cpq(8);
+			assert(cpq.queue_count() == 8 && cpq.empty());
+			int out = -1;
+			assert(!cpq.try_pop(out) && out == -1);
+
+			cpq.set_strict(true);
+			cpq.sample_rank_error(1);
+			stdPQ<int> pq;
+			std::mt19937 gen(1);
+			for (auto i = 0; i != 3000; ++i) {
+				int x = static_cast<int>(gen() % 1000);
+				cpq.push(x);
+				pq.push(x);
+			}
+			assert(cpq.size() == 3000);
+			while (!pq.empty()) {
+				assert(cpq.try_pop(out) && out == pq.top());
+				pq.pop();
+			}
+			assert(cpq.empty() && !cpq.try_pop(out));
+
+			auto stats = cpq.rank_error();
+			assert(stats.samples == 3000 && stats.total == 0 && stats.max == 0 && stats.mean() == 0);
+			cpq.reset_rank_error();
+			assert(cpq.rank_error().samples == 0);
+
+			tsCpq<int> one(1);
+			assert(one.queue_count() == 2);
+		}
+		//relaxed pops return every element once, close to the top
+		void testCase2() {
+			miniSTL::Concurrent_priority_queue<std::string, std::greater<std::string>> cpq(4);
+			cpq.sample_rank_error(1);
+			std::vector<std::string> pushed;
+			for (auto i = 0; i != 2000; ++i) {
+				pushed.push_back(std::to_string(i * 7919 % 2000 + 10000));
+				cpq.push(pushed.back());
+			}
+			std::vector<std::string> popped;
+			std::string s;
+			while (cpq.try_pop(s))
+				popped.push_back(s);
+			std::sort(pushed.begin(), pushed.end());
+			std::sort(popped.begin(), popped.end());
+			assert(popped == pushed);
+
+			//with four heaps a pop is off by a few ranks, never by a sizeable part of the queue
+			auto stats = cpq.rank_error();
+			assert(stats.samples == 2000 && stats.total > 0);
+			assert(stats.mean() < 20 && stats.max < 200);
+		}
+		//producers and consumers at once, every element comes out exactly once
+		void testCase3() {
+			tsCpq<int> cpq(8);
+			const int producers = 4, consumers = 4, per = 5000;
+			std::atomic<int> remaining(producers * per);
+			std::vector<std::vector<int>> taken(consumers);
+			std::vector<std::thread> threads;
+			for (auto t = 0; t != producers; ++t) {
+				threads.push_back(std::thread([&cpq, t, per]() {
+					for (auto i = 0; i != per; ++i)
+						cpq.push(t * per + i);
+				}));
+			}
+			for (auto t = 0; t != consumers; ++t) {
+				threads.push_back(std::thread([&cpq, &remaining, &taken, t]() {
+					int x;
+					while (remaining > 0) {
+						if (cpq.try_pop(x)) {
+							taken[t].push_back(x);
+							--remaining;
+						}
+					}
+				}));
+			}
+			for (auto& th : threads)
+				th.join();
+			assert(cpq.empty());
+
+			std::vector<int> all;
+			for (auto& v : taken)
+				all.insert(all.end(), v.begin(), v.end());
+			std::sort(all.begin(), all.end());
+			assert(all.size() == static_cast<size_t>(producers * per));
+			for (auto i = 0; i != producers * per; ++i)
+				assert(all[i] == i);
+		}
+		//strict mode switched on and off under load, with rank errors sampled
+		void testCase4() {
+			miniSTL::Concurrent_priority_queue<int, miniSTL::less<int>, miniSTL::dary_heap_policy<4>> cpq(4);
+			cpq.sample_rank_error(16);
+			for (auto i = 0; i != 4000; ++i)
+				cpq.push(i);
+			std::atomic<int> popped(0);
+			std::vector<std::thread> threads;
+			for (auto t = 0; t != 3; ++t) {
+				threads.push_back(std::thread([&cpq, &popped]() {
+					int x;
+					for (auto i = 0; i != 1000; ++i) {
+						cpq.push(4000 + i);
+						if (cpq.try_pop(x))
+							++popped;
+					}
+				}));
+			}
+			for (auto round = 0; round != 50; ++round)
+				cpq.set_strict(round % 2 == 0);
+			for (auto& th : threads)
+				th.join();
+			assert(popped == 3000 && cpq.size() == 4000);
+			assert(cpq.rank_error().samples <= 3000);
+		}
+
+		//a comparator that throws once asked to
+		struct ThrowingLess {
+			const bool* fail;
+			bool operator()(int a, int b) const {
+				if (*fail)
+					throw std::runtime_error("compare");
+				return a < b;
+			}
+		};
+
+		//a throwing comparator leaves no heap locked
+		void testCase5() {
+			bool fail = false;
+			ThrowingLess comp = { &fail };
+			miniSTL::Concurrent_priority_queue<int, ThrowingLess> cpq(4, comp);
+			cpq.set_strict(true);
+			for (auto i = 0; i != 100; ++i)
+				cpq.push(i);
+			cpq.sample_rank_error(1);
+
+			fail = true;
+			int x = -1;
+			bool thrown = false;
+			try {
+				cpq.try_pop(x);
+			}
+			catch (const std::runtime_error&) {
+				thrown = true;
+			}
+			assert(thrown);
+
+			fail = false;
+			std::thread other([&cpq]() {
+				int y;
+				assert(cpq.try_pop(y) && y == 99);
+			});
+			other.join();
+			assert(cpq.try_pop(x) && x == 98);
+		}
+
+		void testAllCases() {
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
+		}
+	}
+}
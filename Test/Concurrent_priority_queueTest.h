@@ -0,0 +1,36 @@
+#ifndef _CONCURRENT_PRIORITY_QUEUE_TEST_H_
+#define _CONCURRENT_PRIORITY_QUEUE_TEST_H_
+
+#include "TestUtil.h"
+
+#include "..\Concurrent_priority_queue.h"
+#include <queue>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace miniSTL {
+	namespace Concurrent_priority_queueTest {
+		template<class T>
+		using stdPQ = std::priority_queue < T >;
+		template<class T>
+		using tsCpq = miniSTL::Concurrent_priority_queue < T >;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+		void testCase5();
+
+		void testAllCases();
+	}
+}
+
+#endif
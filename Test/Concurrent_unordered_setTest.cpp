@@ -0,0 +1,124 @@
+#include "Concurrent_unordered_setTest.h"
+
+namespace miniSTL {
+	namespace Concurrent_unordered_setTest {
+		void testCase1() {
+			tsCus<int> cus1(1);
+			assert(cus1.shard_count() == 1 && cus1.empty());
+			tsCus<int> cus2(10);
+			assert(cus2.shard_count() == 16);
+
+			stdUst<int> ust;
+			std::mt19937 gen(1);
+			for (auto i = 0; i != 5000; ++i) {
+				int k = gen() % 2000;
+				assert(cus2.insert(k) == ust.insert(k).second);
+			}
+			for (auto i = 0; i < 2000; i += 7)
+				assert(cus2.erase(i) == ust.erase(i));
+			assert(cus2.size() == ust.size());
+			for (auto i = 0; i != 2000; ++i) {
+				int found = -1;
+				assert(cus2.contains(i) == (ust.count(i) == 1));
+				assert(cus2.find(i, found) == (ust.count(i) == 1));
+				assert(found == (ust.count(i) ? i : -1));
+			}
+			cus2.clear();
+			assert(cus2.empty() && !cus2.contains(1));
+		}
+		//writers on disjoint and on shared keys at the same time
+		void testCase2() {
+			tsCus<std::string> cus(8);
+			std::atomic<int> inserted(0);
+			std::vector<std::thread> threads;
+			for (auto t = 0; t != 4; ++t) {
+				threads.push_back(std::thread([&cus, &inserted, t]() {
+					for (auto i = 0; i != 2000; ++i) {
+						if (cus.insert("own" + std::to_string(t * 2000 + i)))
+							++inserted;
+						if (cus.insert("shared" + std::to_string(i)))
+							++inserted;
+					}
+				}));
+			}
+			for (auto& th : threads)
+				th.join();
+			assert(inserted == 10000);
+			assert(cus.size() == 10000);
+			for (auto i = 0; i != 8000; ++i)
+				assert(cus.contains("own" + std::to_string(i)));
+		}
+		//readers of keys that never change while a writer churns other keys
+		void testCase3() {
+			tsCus<int> cus(4);
+			for (auto i = 0; i != 1000; ++i)
+				cus.insert(i);
+			std::atomic<bool> done(false);
+			std::atomic<int> misses(0);
+			std::vector<std::thread> readers;
+			for (auto t = 0; t != 3; ++t) {
+				readers.push_back(std::thread([&]() {
+					while (!done) {
+						for (auto i = 0; i != 1000; ++i) {
+							if (!cus.contains(i))
+								++misses;
+						}
+					}
+				}));
+			}
+			for (auto round = 0; round != 20; ++round) {
+				for (auto i = 1000; i != 3000; ++i)
+					cus.insert(i);
+				for (auto i = 1000; i != 3000; ++i)
+					cus.erase(i);
+			}
+			done = true;
+			for (auto& th : readers)
+				th.join();
+			assert(misses == 0);
+			assert(cus.size() == 1000);
+		}
+		void testCase4() {
+			tsCus<int> cus(4, 400);
+			for (auto i = 0; i != 1000; ++i)
+				cus.insert(i);
+
+			cus.rehash_shard(2, 5000);
+			size_t total = 0, largest = 0;
+			cus.for_each_shard([&](tsCus<int>::shard_type& s) {
+				total += s.size();
+				largest = s.bucket_count() > largest ? s.bucket_count() : largest;
+			});
+			assert(total == 1000 && largest >= 5000);
+
+			//every key sits in the shard shard_of names
+			size_t index = 0;
+			cus.for_each_shard([&](tsCus<int>::shard_type& s) {
+				for (auto k : s)
+					assert(cus.shard_of(k) == index);
+				++index;
+			});
+			cus.rehash(40000);
+			for (auto i = 0; i != 1000; ++i)
+				assert(cus.contains(i));
+
+			//a shard left migrating by f is settled before the lock is released
+			cus.for_each_shard([&](tsCus<int>::shard_type& s) {
+				s.incremental_rehash(true);
+				s.rehash(s.bucket_count() * 4);
+			});
+			cus.for_each_shard([&](tsCus<int>::shard_type& s) {
+				assert(!s.incremental_rehash() && !s.rehashing());
+			});
+			for (auto i = 0; i != 1000; ++i)
+				assert(cus.contains(i));
+		}
+
+		void testAllCases() {
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+		}
+	}
+}
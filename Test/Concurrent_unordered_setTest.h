@@ -0,0 +1,32 @@
+#ifndef _CONCURRENT_UNORDERED_SET_TEST_H_
+#define _CONCURRENT_UNORDERED_SET_TEST_H_
+
+#include "TestUtil.h"
+
+#include "..\Concurrent_unordered_set.h"
+#include <unordered_set>
+
+#include <atomic>
+#include <cassert>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace miniSTL {
+	namespace Concurrent_unordered_setTest {
+		template<class T>
+		using stdUst = std::unordered_set <T>;
+		template<class T>
+		using tsCus = miniSTL::Concurrent_unordered_set <T>;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+
+		void testAllCases();
+	}
+}
+
+#endif
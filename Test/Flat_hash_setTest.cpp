@@ -0,0 +1,167 @@
+#include "Flat_hash_setTest.h"
+
+namespace miniSTL {
+	namespace Flat_hash_setTest {
+		void testCase1() {
+			stdUst<int> ust1(10);
+			tsFhs<int> fhs1(10);
+			assert(Test::unordered_container_equal(ust1, fhs1));
+			assert(fhs1.empty() && fhs1.begin() == fhs1.end());
+			assert(fhs1.find(3) == fhs1.end() && fhs1.count(3) == 0);
+
+			int arr[] = { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+			stdUst<int> ust2(std::begin(arr), std::end(arr));
+			tsFhs<int> fhs2(std::begin(arr), std::end(arr));
+			assert(Test::unordered_container_equal(ust2, fhs2));
+			assert(fhs2.size() == 10);
+
+			auto fhs3(fhs2);
+			assert(Test::unordered_container_equal(ust2, fhs3));
+
+			tsFhs<int> fhs4;
+			fhs4 = fhs2;
+			assert(Test::unordered_container_equal(ust2, fhs4));
+
+			tsFhs<int> fhs5(std::move(fhs4));
+			assert(fhs4.empty() && Test::unordered_container_equal(ust2, fhs5));
+		}
+		void testCase2() {
+			stdUst<std::string> ust;
+			tsFhs<std::string> fhs;
+			std::mt19937 gen(7);
+			for (auto i = 0; i != 5000; ++i) {
+				auto n = std::to_string(gen() % 4096);
+				auto res = fhs.insert(n);
+				assert(res.second == ust.insert(n).second);
+				assert(*res.first == n);
+			}
+			assert(Test::unordered_container_equal(ust, fhs));
+			assert(fhs.load_factor() <= fhs.max_load_factor());
+
+			for (auto i = 0; i != 4096; ++i) {
+				auto n = std::to_string(i);
+				assert(fhs.count(n) == ust.count(n));
+			}
+		}
+		void testCase3() {
+			//erase and reinsert churn, tombstones must never hide a key or grow the table forever
+			stdUst<int> ust;
+			tsFhs<int> fhs;
+			std::mt19937 gen(11);
+			for (auto i = 0; i != 200000; ++i) {
+				int n = gen() % 1000;
+				if (gen() % 2) {
+					fhs.insert(n);
+					ust.insert(n);
+				}
+				else
+					assert(fhs.erase(n) == ust.erase(n));
+			}
+			assert(fhs.size() == ust.size());
+			assert(Test::unordered_container_equal(ust, fhs));
+			assert(fhs.bucket_count() < 4096);
+			for (auto i = 0; i != 1000; ++i)
+				assert(fhs.count(i) == ust.count(i));
+		}
+		void testCase4() {
+			tsFhs<int> fhs;
+			for (auto i = 0; i != 100; ++i)
+				fhs.insert(i);
+
+			//erase while iterating, erase returns the next element
+			for (auto it = fhs.begin(); it != fhs.end();) {
+				if (*it % 3 == 0)
+					it = fhs.erase(it);
+				else
+					++it;
+			}
+			assert(fhs.size() == 66);
+			for (auto i = 0; i != 100; ++i)
+				assert(fhs.count(i) == (i % 3 != 0 ? 1 : 0));
+
+			fhs.clear();
+			assert(fhs.empty() && fhs.begin() == fhs.end());
+			fhs.insert(42);
+			assert(fhs.size() == 1 && *fhs.begin() == 42);
+		}
+		void testCase5() {
+			tsFhs<int> fhs;
+			fhs.reserve(1000);
+			auto buckets = fhs.bucket_count();
+			assert(buckets >= 1000);
+			for (auto i = 0; i != 1000; ++i)
+				fhs.insert(i * 7);
+			assert(fhs.bucket_count() == buckets);
+
+			fhs.rehash(buckets * 4);
+			assert(fhs.bucket_count() >= buckets * 4 && fhs.size() == 1000);
+			for (auto i = 0; i != 1000; ++i)
+				assert(fhs.find(i * 7) != fhs.end() && *fhs.find(i * 7) == i * 7);
+
+			tsFhs<int> other;
+			other.insert(-1);
+			miniSTL::swap(fhs, other);
+			assert(fhs.size() == 1 && other.size() == 1000);
+			assert(fhs.count(-1) == 1 && other.count(-1) == 0);
+
+			//a table takes max_load_factor() * bucket_count() keys, the next one grows it
+			tsFhs<int> small;
+			small.insert(0);
+			const auto cap = small.bucket_count();
+			const auto limit = static_cast<size_t>(small.max_load_factor() * cap + 0.5f);
+			for (auto i = 1; small.bucket_count() == cap; ++i)
+				small.insert(i);
+			assert(small.size() == limit + 1);
+		}
+
+		//a key whose copy throws once asked to
+		struct ThrowingKey {
+			int v;
+			const bool* fail;
+			ThrowingKey(int x, const bool* f) : v(x), fail(f) {}
+			ThrowingKey(const ThrowingKey& k) : v(k.v), fail(k.fail) {
+				if (*fail)
+					throw std::runtime_error("copy");
+			}
+			bool operator == (const ThrowingKey& k) const { return v == k.v; }
+		};
+		struct ThrowingKeyHash {
+			size_t operator()(const ThrowingKey& k) const { return std::hash<int>()(k.v); }
+		};
+		void testCase6() {
+			bool fail = false;
+			miniSTL::flat_hash_set<ThrowingKey, ThrowingKeyHash> fhs;
+			fhs.reserve(64);
+			for (auto i = 0; i != 20; ++i)
+				fhs.insert(ThrowingKey(i, &fail));
+
+			//a copy that throws leaves the set as it was, the destructor then frees only real keys
+			fail = true;
+			bool thrown = false;
+			try {
+				fhs.insert(ThrowingKey(100, &fail));
+			}
+			catch (const std::runtime_error&) {
+				thrown = true;
+			}
+			fail = false;
+			assert(thrown && fhs.size() == 20);
+			assert(fhs.count(ThrowingKey(100, &fail)) == 0);
+			size_t n = 0;
+			for (auto it = fhs.begin(); it != fhs.end(); ++it)
+				n += it->v < 20 ? 1 : 0;
+			assert(n == 20);
+			fhs.insert(ThrowingKey(100, &fail));
+			assert(fhs.size() == 21 && fhs.count(ThrowingKey(100, &fail)) == 1);
+		}
+
+		void testAllCases() {
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
+			testCase6();
+		}
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef _FLAT_HASH_SET_TEST_H_
+#define _FLAT_HASH_SET_TEST_H_
+
+#include "TestUtil.h"
+
+#include "..\Flat_hash_set.h"
+#include <unordered_set>
+
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace miniSTL {
+	namespace Flat_hash_setTest {
+		template<class T>
+		using stdUst = std::unordered_set <T>;
+		template<class T>
+		using tsFhs = miniSTL::flat_hash_set <T>;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+		void testCase5();
+		void testCase6();
+
+		void testAllCases();
+	}
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include "Indexed_priority_queueTest.h"
+
+namespace miniSTL {
+	namespace Indexed_priority_queueTest {
+		void testCase1() {
+			int arr[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, -1, -2, -3, 5, 5 };
+			stdPQ<int> pq1(std::begin(arr), std::end(arr));
+			tsIPQ<int> pq2;
+			assert(pq2.empty());
+			for (auto x : arr) {
+				auto h = pq2.push(x);
+				assert(pq2.contains(h) && pq2.get(h) == x);
+			}
+			assert(pq2.size() == pq1.size());
+
+			while (!pq1.empty() && !pq2.empty()) {
+				assert(pq1.top() == pq2.top());
+				assert(pq2.get(pq2.top_handle()) == pq2.top());
+				pq1.pop(); pq2.pop();
+			}
+			assert(pq1.empty() && pq2.empty());
+		}
+		void testCase2() {
+			tsIPQ<std::string> pq;
+			auto a = pq.push("b"), b = pq.push("d"), c = pq.push("f");
+			assert(pq.top() == "f");
+
+			//raise and lower in place
+			pq.update(a, "z");
+			assert(pq.top() == "z" && pq.top_handle() == a);
+			pq.update(a, "a");
+			assert(pq.top() == "f" && pq.get(a) == "a");
+
+			pq.erase(c);
+			assert(!pq.contains(c) && pq.size() == 2 && pq.top() == "d");
+
+			//a reused slot does not bring the erased handle back
+			auto d = pq.push("e");
+			assert(d.slot == c.slot && d != c);
+			assert(pq.contains(d) && !pq.contains(c));
+
+			pq.pop();
+			assert(!pq.contains(d) && pq.top_handle() == b);
+
+			pq.clear();
+			assert(pq.empty() && !pq.contains(a) && !pq.contains(b));
+			auto e = pq.push("x");
+			assert(pq.contains(e) && pq.top() == "x");
+		}
+
+		//random pushes, pops, updates and erases against a plain list of live elements
+		template<int Arity>
+		void checkAgainstList(std::mt19937& gen) {
+			typedef miniSTL::indexed_priority_queue<int, std::greater<int>, miniSTL::dary_heap_policy<Arity>> queue;
+			queue pq;
+			std::vector<std::pair<typename queue::handle_type, int>> live;
+			std::vector<typename queue::handle_type> dead;
+			for (auto step = 0; step != 20000; ++step) {
+				const auto op = gen() % 10;
+				if (op < 4 || live.empty()) {
+					int x = static_cast<int>(gen() % 1000);
+					live.push_back(std::make_pair(pq.push(x), x));
+				}
+				else if (op < 7) {
+					auto& e = live[gen() % live.size()];
+					e.second = static_cast<int>(gen() % 1000);
+					pq.update(e.first, e.second);
+				}
+				else if (op < 9) {
+					auto i = gen() % live.size();
+					pq.erase(live[i].first);
+					dead.push_back(live[i].first);
+					live[i] = live.back();
+					live.pop_back();
+				}
+				else {
+					auto h = pq.top_handle();
+					pq.pop();
+					for (auto& e : live) {
+						if (e.first == h) {
+							e = live.back();
+							live.pop_back();
+							break;
+						}
+					}
+					dead.push_back(h);
+				}
+
+				assert(pq.size() == live.size());
+				if (!live.empty()) {
+					int least = live[0].second;
+					for (auto& e : live)
+						least = e.second < least ? e.second : least;
+					assert(pq.top() == least && pq.get(pq.top_handle()) == least);
+				}
+				if (step % 1000 == 0) {
+					for (auto& e : live)
+						assert(pq.contains(e.first) && pq.get(e.first) == e.second);
+					for (auto& h : dead)
+						assert(!pq.contains(h));
+				}
+			}
+		}
+		void testCase3() {
+			std::mt19937 gen(3);
+			checkAgainstList<2>(gen);
+			checkAgainstList<4>(gen);
+		}
+		void testCase4() {
+			tsIPQ<int> foo, bar;
+			auto h = foo.push(15); foo.push(30); foo.push(10);
+			bar.push(101); bar.push(202);
+
+			foo.swap(bar);
+			assert(foo.size() == 2 && bar.size() == 3);
+			assert(bar.contains(h) && bar.get(h) == 15);
+
+			miniSTL::swap(foo, bar);
+			assert(foo.size() == 3 && bar.size() == 2);
+			foo.update(h, 40);
+			assert(foo.top() == 40);
+		}
+
+		void testAllCases() {
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+		}
+	}
+}
@@ -0,0 +1,31 @@
+#ifndef _INDEXED_PRIORITY_QUEUE_TEST_H_
+#define _INDEXED_PRIORITY_QUEUE_TEST_H_
+
+#include "TestUtil.h"
+
+#include "../Indexed_priority_queue.h"
+#include <queue>
+
+#include <cassert>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace miniSTL {
+	namespace Indexed_priority_queueTest {
+		template<class T>
+		using stdPQ = std::priority_queue < T >;
+		template<class T>
+		using tsIPQ = miniSTL::indexed_priority_queue < T >;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+
+		void testAllCases();
+	}
+}
+
+#endif
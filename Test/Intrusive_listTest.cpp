@@ -0,0 +1,140 @@
+#include "Intrusive_listTest.h"
+
+namespace miniSTL {
+	namespace Intrusive_listTest {
+		template <class Container>
+		std::vector<int> keys(const Container& con) {
+			std::vector<int> res;
+			for (auto it = con.begin(); it != con.end(); ++it)
+				res.push_back(it->key);
+			return res;
+		}
+
+		void testCase1() {
+			std::vector<Item> pool;
+			for (auto i = 0; i != 10; ++i)
+				pool.push_back(Item(i, i));
+
+			stdL<int> l1;
+			tsL l2;
+			assert(l2.empty());
+			for (auto i = 0; i != 5; ++i) {
+				l1.push_back(i);
+				l2.push_back(pool[i]);
+				l1.push_front(i + 5);
+				l2.push_front(pool[i + 5]);
+			}
+			assert(std::vector<int>(l1.begin(), l1.end()) == keys(l2));
+			assert(l2.size() == 10 && pool[3].intrusive_list_hook<>::is_linked());
+
+			l1.pop_front(); l1.pop_back();
+			l2.pop_front(); l2.pop_back();
+			assert(std::vector<int>(l1.begin(), l1.end()) == keys(l2));
+			assert(!pool[9].intrusive_list_hook<>::is_linked());
+
+			l2.clear();
+			assert(l2.empty() && !pool[3].intrusive_list_hook<>::is_linked());
+		}
+		void testCase2() {
+			std::vector<Item> pool;
+			for (auto i = 0; i != 8; ++i)
+				pool.push_back(Item(i, i));
+
+			tsL all;
+			lruL lru;
+			for (auto& item : pool) {
+				all.push_back(item);
+				lru.push_front(item);
+			}
+
+			//touching an item moves it to the front of the LRU list without disturbing the other list
+			lru.splice(lru.begin(), lru, lru.iterator_to(pool[2]));
+			assert(&lru.front() == &pool[2]);
+			assert(&lru.back() == &pool[0]);
+			assert(lru.size() == 8 && all.size() == 8);
+
+			auto it = all.erase(all.iterator_to(pool[4]));
+			assert(&*it == &pool[5]);
+			assert(all.size() == 7 && lru.size() == 8);
+
+			int disposed = 0;
+			lru.remove_and_dispose_if([](const Item& x) { return x.key % 2 == 0; },
+				[&disposed](Item&) { ++disposed; });
+			assert(disposed == 4 && lru.size() == 4);
+		}
+		void testCase3() {
+			std::vector<Item> pool;
+			std::mt19937 gen(28);
+			for (auto i = 0; i != 5000; ++i)
+				pool.push_back(Item(static_cast<int>(gen() % 100), i));
+
+			tsL l;
+			for (auto& item : pool)
+				l.push_back(item);
+			l.sort();
+
+			//stable: equal keys keep their insertion order
+			auto prev = l.begin();
+			for (auto it = ++l.begin(); it != l.end(); ++it, ++prev) {
+				assert(prev->key <= it->key);
+				if (prev->key == it->key)
+					assert(prev->id < it->id);
+			}
+			assert(l.size() == 5000);
+
+			l.sort([](const Item& a, const Item& b) { return a.key > b.key; });
+			assert(l.front().key == 99 && l.back().key == 0);
+		}
+		void testCase4() {
+			int arr1[] = { 0, 1, 3, 5, 9 }, arr2[] = { 2, 4, 6, 7, 8 };
+			std::vector<Item> pool1, pool2;
+			for (auto n : arr1) pool1.push_back(Item(n));
+			for (auto n : arr2) pool2.push_back(Item(n));
+
+			tsL first, second;
+			first.insert(first.end(), pool1.begin(), pool1.end());
+			second.insert(second.end(), pool2.begin(), pool2.end());
+			first.merge(second);
+			assert(second.empty() && first.size() == 10);
+			assert(keys(first) == std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+
+			first.reverse();
+			assert(first.front().key == 9 && first.back().key == 0);
+
+			tsL third;
+			third.splice(third.end(), first, first.begin(), first.iterator_to(pool2[1]));
+			assert(keys(third) == std::vector<int>({ 9, 8, 7, 6, 5 }));
+			assert(first.size() == 5 && third.size() == 5);
+		}
+		void testCase5() {
+			int arr[] = { 0, 0, 1, 2, 2, 3, 3, 4, 4, 4, 5, 5, 6, 7, 8, 8, 9, 11 };
+			std::vector<Item> pool;
+			for (auto n : arr) pool.push_back(Item(n));
+
+			stdL<int> l1(std::begin(arr), std::end(arr));
+			tsL l2;
+			l2.insert(l2.end(), pool.begin(), pool.end());
+
+			l1.unique();
+			l2.unique();
+			assert(std::vector<int>(l1.begin(), l1.end()) == keys(l2));
+
+			l1.remove(8);
+			l2.remove(Item(8));
+			assert(std::vector<int>(l1.begin(), l1.end()) == keys(l2));
+
+			tsL l3(std::move(l2));
+			assert(l2.empty() && l3.size() == l1.size());
+			miniSTL::swap(l2, l3);
+			assert(l3.empty() && std::vector<int>(l1.begin(), l1.end()) == keys(l2));
+		}
+
+		void testAllCases() {
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#ifndef _INTRUSIVE_LIST_TEST_H_
+#define _INTRUSIVE_LIST_TEST_H_
+
+#include "TestUtil.h"
+
+#include "../Intrusive_list.h"
+#include <list>
+#include <vector>
+
+#include <cassert>
+#include <functional>
+#include <random>
+
+namespace miniSTL {
+	namespace Intrusive_listTest {
+		struct LruTag {};
+
+		//an object that can sit in one default list and one LRU list at once
+		struct Item : public intrusive_list_hook<>, public intrusive_list_hook<LruTag> {
+			int key;
+			int id;
+
+			explicit Item(int k = 0, int i = 0) : key(k), id(i) {}
+			bool operator == (const Item& x) const { return key == x.key; }
+			bool operator != (const Item& x) const { return key != x.key; }
+			bool operator < (const Item& x) const { return key < x.key; }
+		};
+
+		template<class T>
+		using stdL = std::list < T >;
+		typedef miniSTL::intrusive_list<Item> tsL;
+		typedef miniSTL::intrusive_list<Item, LruTag> lruL;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+		void testCase5();
+
+		void testAllCases();
+	}
+}
+
+#endif
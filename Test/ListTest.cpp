@@ -117,7 +117,44 @@ namespace miniSTL {
 			miniSTL::swap(l1, l2);
 			assert(l1.size() == 3 && l2.size() == 2);
 		}
-		
+		void testCase9() {
+			stdL<int> l1;
+			tsL<int> l2;
+			std::mt19937 gen(2016);
+			for (auto i = 0; i != 10000; ++i) {
+				auto n = static_cast<int>(gen() % 1000);
+				l1.push_back(n);
+				l2.push_back(n);
+			}
+			l1.sort();
+			l2.sort();
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			l1.sort(std::greater<int>());
+			l2.sort(std::greater<int>());
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			//sort and merge only use the comparator and keep equal keys in order
+			typedef std::pair<int, int> P;
+			auto byFirst = [](const P& a, const P& b) { return a.first < b.first; };
+			stdL<P> l3, l5;
+			tsL<P> l4, l6;
+			for (auto i = 0; i != 1000; ++i) {
+				P p(static_cast<int>(gen() % 10), i);
+				l3.push_back(p);
+				l4.push_back(p);
+				P q(static_cast<int>(gen() % 10), -i);
+				l5.push_back(q);
+				l6.push_back(q);
+			}
+			l3.sort(byFirst); l5.sort(byFirst);
+			l4.sort(byFirst); l6.sort(byFirst);
+			assert(miniSTL::Test::container_equal(l3, l4));
+			l3.merge(l5, byFirst);
+			l4.merge(l6, byFirst);
+			assert(miniSTL::Test::container_equal(l3, l4));
+			assert(l6.empty() && l4.size() == 2000);
+		}
 		void testCase10() {
 			int arr[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
 			stdL<int> l1(std::begin(arr), std::end(arr));
@@ -183,7 +220,72 @@ namespace miniSTL {
 			l2.splice(it2, l6, l6.begin(), l6.end());
 			assert(miniSTL::Test::container_equal(l1, l2));
 		}
-		
+		void testCase15() {
+			typedef std::pair<std::string, int> P;
+			stdL<P> l1;
+			tsL<P> l2;
+			l1.emplace_back("b", 2); l1.emplace_front("a", 1);
+			l2.emplace_back("b", 2); l2.emplace_front("a", 1);
+			l1.emplace(++l1.begin(), "c", 3);
+			l2.emplace(++l2.begin(), "c", 3);
+			P p("d", 4);
+			l1.push_back(std::move(p));
+			p = P("d", 4);
+			l2.push_back(std::move(p));
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			//assignment writes into the nodes the destination already owns
+			tsL<int> l3(5, 1), l4(3, 2);
+			auto front = &l3.front();
+			l3 = l4;
+			assert(&l3.front() == front);
+			assert(l3.size() == 3 && l3 == l4);
+			int arr[] = { 1, 2, 3, 4, 5, 6 };
+			l3.assign(std::begin(arr), std::end(arr));
+			assert(&l3.front() == front);
+			assert(l3.size() == 6 && l3.back() == 6);
+
+			//a node moves between lists without being reallocated
+			auto it = l3.begin();
+			++it;
+			auto addr = &*it;
+			auto nh = l3.extract(it);
+			assert(!nh.empty() && nh.value() == 2);
+			assert(l3.size() == 5);
+			auto pos = l4.insert(l4.end(), std::move(nh));
+			assert(nh.empty() && &*pos == addr);
+			assert(l4.size() == 4 && l4.back() == 2);
+
+			tsL<int> l5(std::move(l4));
+			assert(l4.empty() && l5.size() == 4);
+		}
+		void testCase16() {
+			//the header holds no element, so T needs no default constructor
+			struct NoDefault {
+				int v;
+				explicit NoDefault(int x) : v(x) {}
+				bool operator == (const NoDefault& rhs) const { return v == rhs.v; }
+			};
+			tsL<NoDefault> l1;
+			assert(l1.empty() && l1.begin() == l1.end());
+			l1.emplace_back(2);
+			l1.emplace_front(1);
+			l1.push_back(NoDefault(3));
+			assert(l1.size() == 3 && l1.front().v == 1 && l1.back().v == 3);
+
+			tsL<NoDefault> l2;
+			l2.swap(l1);
+			assert(l1.empty() && l2.size() == 3);
+			l1.swap(l2);
+			assert(l2.empty() && l1.size() == 3);
+			l1.reverse();
+			assert(l1.front().v == 3 && l1.back().v == 1);
+			l2.splice(l2.end(), l1);
+			assert(l1.empty() && l2.size() == 3 && (--l2.end())->v == 1);
+			l2.pop_front();
+			l2.pop_back();
+			assert(l2.size() == 1 && l2.front().v == 2);
+		}
 
 
 		void testAllCases() {
@@ -195,13 +297,14 @@ namespace miniSTL {
 			testCase6();
 			testCase7();
 			testCase8();
-			//testCase9();
+			testCase9();
 			testCase10();
 			testCase11();
 			testCase12();
 			testCase13();
 			testCase14();
-			//testCase15();
+			testCase15();
+			testCase16();
 		}
 	}
 }
\ No newline at end of file
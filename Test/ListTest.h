@@ -26,13 +26,14 @@ namespace miniSTL {
 		void testCase6();
 		void testCase7();
 		void testCase8();
-		//void testCase9();
+		void testCase9();
 		void testCase10();
 		void testCase11();
 		void testCase12();
 		void testCase13();
 		void testCase14();
-		//void testCase15();
+		void testCase15();
+		void testCase16();
 
 		void testAllCases();
 	}
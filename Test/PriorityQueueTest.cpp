@@ -65,12 +65,205 @@ namespace miniSTL {
 			assert(foo.size() == 3 && bar.size() == 2);
 		}
 
+		//every node orders at or before its parent
+		template<class Vec, class Compare, class HeapPolicy>
+		bool is_heap(const Vec& v, Compare comp, HeapPolicy) {
+			for (size_t i = 1; i < v.size(); ++i) {
+				if (comp(v[HeapPolicy::parent(i)], v[i]))
+					return false;
+			}
+			return true;
+		}
+
+		template<int Arity>
+		void checkHeapAlgorithms(std::mt19937& gen) {
+			typedef miniSTL::dary_heap_policy<Arity> policy;
+			for (auto n : { 0, 1, 2, 3, Arity, Arity + 1, 100, 1001 }) {
+				std::vector<int> v;
+				for (auto i = 0; i != n; ++i)
+					v.push_back(static_cast<int>(gen() % 50));
+				auto sorted = v;
+				std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+
+				//a min-heap, so a comparator ignored anywhere shows up
+				auto h = v;
+				miniSTL::make_heap(h.begin(), h.end(), std::greater<int>(), policy());
+				assert(is_heap(h, std::greater<int>(), policy()));
+				miniSTL::sort_heap(h.begin(), h.end(), std::greater<int>(), policy());
+				assert(h == sorted);
+
+				std::vector<int> p;
+				for (auto x : v) {
+					p.push_back(x);
+					miniSTL::push_heap(p.begin(), p.end(), std::greater<int>(), policy());
+					assert(is_heap(p, std::greater<int>(), policy()));
+				}
+				for (auto i = n; i != 0; --i) {
+					miniSTL::pop_heap(p.begin(), p.begin() + i, std::greater<int>(), policy());
+					assert(p[i - 1] == sorted[sorted.size() - (n - i) - 1]);
+					p.pop_back();
+					assert(is_heap(p, std::greater<int>(), policy()));
+				}
+			}
+		}
+
+		void testCase6() {
+			std::mt19937 gen(6);
+			checkHeapAlgorithms<2>(gen);
+			checkHeapAlgorithms<3>(gen);
+			checkHeapAlgorithms<4>(gen);
+			checkHeapAlgorithms<8>(gen);
+
+			//the default policy is still the binary heap std::priority_queue keeps, so a heap built
+			//by either side is popped correctly by the other
+			std::vector<int> v;
+			for (auto i = 0; i != 500; ++i)
+				v.push_back(static_cast<int>(gen()));
+			auto h1 = v, h2 = v;
+			miniSTL::make_heap(h1.begin(), h1.end());
+			std::make_heap(h2.begin(), h2.end());
+			assert(is_heap(h1, std::less<int>(), miniSTL::binary_heap_policy()));
+			assert(std::is_heap(h1.begin(), h1.end()));
+			assert(is_heap(h2, std::less<int>(), miniSTL::binary_heap_policy()));
+			for (auto n = h1.size(); n != 0; --n) {
+				assert(h1[0] == h2[0]);
+				std::pop_heap(h1.begin(), h1.begin() + n);
+				miniSTL::pop_heap(h2.begin(), h2.begin() + n);
+			}
+			assert(h1 == h2 && std::is_sorted(h1.begin(), h1.end()));
+		}
+
+		void testCase7() {
+			std::mt19937 gen(7);
+			stdPQ<int> pq1;
+			tsDaryPQ<int, 4> pq2;
+			tsDaryPQ<int, 8> pq3;
+			for (auto round = 0; round != 50; ++round) {
+				for (auto i = 0; i != 200; ++i) {
+					int x = static_cast<int>(gen() % 1000);
+					pq1.push(x);
+					pq2.push(x);
+					pq3.push(x);
+				}
+				for (auto i = 0; i != 150; ++i) {
+					assert(pq1.top() == pq2.top() && pq1.top() == pq3.top());
+					pq1.pop();
+					pq2.pop();
+					pq3.pop();
+				}
+			}
+			assert(pq1.size() == pq2.size() && pq1.size() == pq3.size());
+
+			//the range constructor orders by the comparator it was given
+			int arr[] = { 5, 3, 9, 1, 7, 1, 8 };
+			tsDaryPQ<int, 4, std::greater<int>> pq4(std::begin(arr), std::end(arr));
+			std::priority_queue<int, std::vector<int>, std::greater<int>> pq5(std::begin(arr), std::end(arr));
+			while (!pq5.empty()) {
+				assert(pq4.top() == pq5.top());
+				pq4.pop();
+				pq5.pop();
+			}
+			assert(pq4.empty());
+		}
+
+		//counts its copies, the heap algorithms should only ever move it
+		struct Tracked {
+			static int copies;
+			int value;
+
+			explicit Tracked(int v = 0) : value(v) {}
+			Tracked(const Tracked& t) : value(t.value) { ++copies; }
+			Tracked(Tracked&& t) : value(t.value) {}
+			Tracked& operator = (const Tracked& t) { value = t.value; ++copies; return *this; }
+			Tracked& operator = (Tracked&& t) { value = t.value; return *this; }
+		};
+		int Tracked::copies = 0;
+
+		struct CountingLess {
+			size_t* count;
+			bool operator()(const Tracked& a, const Tracked& b) const { ++*count; return a.value < b.value; }
+		};
+
+		void testCase8() {
+			std::mt19937 gen(8);
+			const int n = 4096, levels = 12;
+			std::vector<Tracked> v;
+			for (auto i = 0; i != n; ++i)
+				v.push_back(Tracked(static_cast<int>(gen())));
+			size_t compares = 0;
+			CountingLess comp = { &compares };
+
+			Tracked::copies = 0;
+			miniSTL::make_heap(v.begin(), v.end(), comp);
+			for (auto i = n; i != 1; --i)
+				miniSTL::pop_heap(v.begin(), v.begin() + i, comp);
+			for (auto i = 1; i != n; ++i)
+				miniSTL::push_heap(v.begin(), v.begin() + i + 1, comp);
+			assert(Tracked::copies == 0);
+
+			//Floyd's pop takes about one comparison per level where a plain sift takes two,
+			//n pops of the sorted range cost well under 2 n log n
+			miniSTL::make_heap(v.begin(), v.end(), comp);
+			compares = 0;
+			miniSTL::sort_heap(v.begin(), v.end(), comp);
+			assert(compares < static_cast<size_t>(n * levels * 5 / 4));
+			for (auto i = 1; i != n; ++i)
+				assert(v[i - 1].value <= v[i].value);
+		}
+
+		void testCase9() {
+			std::mt19937 gen(9);
+			stdPQ<int> pq1;
+			tsPQ<int> pq2;
+			//batches smaller and larger than the queue take the two different paths
+			for (auto batch : { 10, 0, 5, 500, 30, 2000, 1 }) {
+				std::vector<int> v;
+				for (auto i = 0; i != batch; ++i)
+					v.push_back(static_cast<int>(gen() % 1000));
+				for (auto x : v)
+					pq1.push(x);
+				pq2.push_range(v.data(), v.data() + v.size());
+				assert(pq1.size() == pq2.size());
+				assert(pq1.top() == pq2.top());
+			}
+
+			std::vector<int> out;
+			pq2.pop_n(0, std::back_inserter(out));
+			assert(out.empty());
+			pq2.pop_n(100, std::back_inserter(out));
+			assert(out.size() == 100 && pq2.size() == pq1.size() - 100);
+			for (auto x : out) {
+				assert(x == pq1.top());
+				pq1.pop();
+			}
+
+			//asking for more than is queued empties the queue
+			out.clear();
+			pq2.pop_n(pq2.size() + 5, std::back_inserter(out));
+			assert(pq2.empty() && out.size() == pq1.size());
+			for (auto x : out) {
+				assert(x == pq1.top());
+				pq1.pop();
+			}
+
+			tsDaryPQ<std::string, 4, std::greater<std::string>> pq3;
+			std::string words[] = { "d", "a", "c", "b", "e" };
+			pq3.push_range(std::begin(words), std::end(words));
+			std::string first[3];
+			assert(pq3.pop_n(3, first) == first + 3);
+			assert(first[0] == "a" && first[1] == "b" && first[2] == "c" && pq3.size() == 2);
+		}
+
 		void testAllCases() {
 			testCase1();
 			testCase2();
 			testCase3();
 			testCase4();
 			testCase5();
+			testCase6();
+			testCase7();
+			testCase8();
+			testCase9();
 		}
 	}
 }
\ No newline at end of file
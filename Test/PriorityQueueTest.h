@@ -8,7 +8,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <functional>
+#include <random>
 #include <string>
+#include <vector>
 
 namespace miniSTL {
 	namespace PriorityQueueTest {
@@ -16,12 +19,18 @@ namespace miniSTL {
 		using stdPQ = std::priority_queue < T >;
 		template<class T>
 		using tsPQ = miniSTL::priority_queue < T >;
+		template<class T, int Arity, class Compare = miniSTL::less<T>>
+		using tsDaryPQ = miniSTL::priority_queue < T, miniSTL::vector<T>, Compare, miniSTL::dary_heap_policy<Arity> >;
 
 		void testCase1();
 		void testCase2();
 		void testCase3();
 		void testCase4();
 		void testCase5();
+		void testCase6();
+		void testCase7();
+		void testCase8();
+		void testCase9();
 
 		void testAllCases();
 	}
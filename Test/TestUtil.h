@@ -1,9 +1,12 @@
 #ifndef _TEST_UTIL_H_
 #define _TEST_UTIL_H_
 
+#include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace miniSTL 
 {
@@ -28,6 +31,47 @@ namespace miniSTL
 			}
 			return (first1 == last1) && (first2 == last2);
 		}
+
+		//the same elements in any order, for containers without a defined iteration order
+		template <class Container1, class Container2>
+		bool unordered_container_equal(Container1& con1, Container2& con2) {
+			std::vector<typename Container1::value_type> vec1, vec2;
+			for (auto& item : con1) {
+				vec1.push_back(item);
+			}
+			for (auto& item : con2) {
+				vec2.push_back(item);
+			}
+			std::sort(vec1.begin(), vec1.end());
+			std::sort(vec2.begin(), vec2.end());
+			return vec1 == vec2;
+		}
+
+		//a (pointer, length) view of characters, never converted to std::string by the hash tables
+		struct CharSpan {
+			const char* p;
+			size_t n;
+			CharSpan(const char* str) : p(str), n(std::strlen(str)) {}
+		};
+		//FNV-1a over the characters, seeded so a default constructed copy would hash differently
+		struct SpanHash {
+			typedef void is_transparent;
+			size_t seed;
+			explicit SpanHash(size_t s = 0) : seed(s) {}
+			size_t hashChars(const char* p, size_t n) const {
+				size_t h = 14695981039346656037ULL ^ seed;
+				for (size_t i = 0; i != n; ++i)
+					h = (h ^ static_cast<unsigned char>(p[i])) * 1099511628211ULL;
+				return h;
+			}
+			size_t operator()(const std::string& s) const { return hashChars(s.data(), s.size()); }
+			size_t operator()(const CharSpan& s) const { return hashChars(s.p, s.n); }
+		};
+		struct SpanEqual {
+			typedef void is_transparent;
+			bool operator()(const std::string& a, const std::string& b) const { return a == b; }
+			bool operator()(const std::string& a, const CharSpan& b) const { return a.size() == b.n && a.compare(0, b.n, b.p) == 0; }
+		};
 	}
 }
 
@@ -0,0 +1,122 @@
+#include "Unordered_mapTest.h"
+
+namespace miniSTL {
+	namespace Unordered_mapTest {
+		template<class Map1, class Map2>
+		bool map_equal(Map1& m1, Map2& m2) {
+			if (m1.size() != m2.size())
+				return false;
+			for (auto& item : m1) {
+				auto it = m2.find(item.first);
+				if (it == m2.end() || !(it->second == item.second))
+					return false;
+			}
+			return true;
+		}
+		void testCase1() {
+			stdUmap<std::string, int> um1;
+			tsUmap<std::string, int> um2(10);
+			assert(um2.empty() && um2.begin() == um2.end());
+
+			std::mt19937 gen(1);
+			for (auto i = 0; i != 5000; ++i) {
+				auto word = std::to_string(gen() % 700);
+				++um1[word];
+				++um2[word];
+			}
+			assert(map_equal(um1, um2));
+			assert(um2.find("no such word") == um2.end());
+
+			for (auto i = 0; i < 700; i += 3) {
+				auto word = std::to_string(i);
+				assert(um2.erase(word) == um1.erase(word));
+			}
+			assert(map_equal(um1, um2));
+
+			auto um3 = um2;
+			assert(map_equal(um1, um3));
+			um3.clear();
+			assert(um3.empty() && um2.size() == um1.size());
+		}
+		//counts how often a mapped value is built
+		struct Counted {
+			static int built;
+			int v;
+			explicit Counted(int x = 0) : v(x) { ++built; }
+			Counted(const Counted& c) : v(c.v) { ++built; }
+			bool operator == (const Counted& c) const { return v == c.v; }
+		};
+		int Counted::built = 0;
+		void testCase2() {
+			tsUmap<int, Counted> um(10);
+			assert(um.try_emplace(1, 10).second);
+			assert(Counted::built == 1);
+			//present: nothing is built and the value stays
+			auto res = um.try_emplace(1, 20);
+			assert(!res.second && res.first->second.v == 10 && Counted::built == 1);
+
+			assert(um.insert_or_assign(1, Counted(30)).second == false);
+			assert(um.find(1)->second.v == 30);
+			assert(um.insert_or_assign(2, Counted(40)).second);
+			assert(um[2].v == 40 && um[3].v == 0);
+			assert(um.size() == 3);
+
+			//move-only mapped values go straight into the node
+			tsUmap<int, std::unique_ptr<int>> owners(10);
+			owners.try_emplace(7, new int(7));
+			owners.insert_or_assign(8, std::unique_ptr<int>(new int(8)));
+			owners.insert_or_assign(7, std::unique_ptr<int>(new int(70)));
+			assert(*owners[7] == 70 && *owners[8] == 8 && !owners[9]);
+		}
+		void testCase3() {
+			miniSTL::Unordered_map<std::string, int, Test::SpanHash, Test::SpanEqual> um(10);
+			um.incremental_rehash(true);
+			for (auto i = 0; i != 2000; ++i)
+				um[std::to_string(i)] = i;
+			assert(um.size() == 2000);
+
+			assert(um.find(Test::CharSpan("1234"))->second == 1234);
+			assert(um.count(Test::CharSpan("2000")) == 0);
+			assert(um.erase(Test::CharSpan("17")) == 1 && um.count(std::string("17")) == 0);
+
+			std::string key("99");
+			size_t h = um.hash_function()(key);
+			assert(um.find(key, h)->second == 99);
+
+			std::vector<std::string> keys = { "1", "17", "1999", "x" };
+			assert(um.count_batch(keys.begin(), keys.end()) == 2);
+		}
+		void testCase4() {
+			std::vector<miniSTL::pair<int, int>> vec;
+			for (auto i = 0; i != 3000; ++i)
+				vec.push_back(miniSTL::pair<int, int>(i % 1000, i));
+			tsUmap<int, int> um1(vec.begin(), vec.end());
+			assert(um1.size() == 1000);
+			//the first pair of each key wins, as with repeated insert
+			for (auto i = 0; i != 1000; ++i)
+				assert(um1.find(i)->second == i);
+
+			tsUmap<int, int> um2(10);
+			um2.insert(vec.begin(), vec.end());
+			assert(map_equal(um1, um2));
+			um2.insert(miniSTL::pair<const int, int>(5000, 1));
+			um1.swap(um2);
+			assert(um1.size() == 1001 && um2.size() == 1000);
+
+			//shrinking keeps the mapped values with their keys
+			um1.min_load_factor(0.1f);
+			for (auto i = 0; i != 990; ++i)
+				um1.erase(i);
+			assert(um1.bucket_count() < 1000);
+			um1.shrink_to_fit();
+			assert(um1.size() == 11 && um1[995] == 995 && um1[5000] == 1);
+		}
+
+		void testAllCases() {
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+		}
+	}
+}
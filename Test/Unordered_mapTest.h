@@ -0,0 +1,32 @@
+#ifndef _UNORDERED_MAP_TEST_H_
+#define _UNORDERED_MAP_TEST_H_
+
+#include "TestUtil.h"
+
+#include "..\Unordered_map.h"
+#include <unordered_map>
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace miniSTL {
+	namespace Unordered_mapTest {
+		template<class K, class V>
+		using stdUmap = std::unordered_map <K, V>;
+		template<class K, class V>
+		using tsUmap = miniSTL::Unordered_map <K, V>;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+
+		void testAllCases();
+	}
+}
+
+#endif
@@ -2,36 +2,23 @@
 
 namespace miniSTL {
 	namespace Unordered_setTest {
-		template<class Container1, class Container2>
-		bool container_equal(Container1& con1, Container2& con2) {
-			std::vector<typename Container1::value_type> vec1, vec2;
-			for (auto& item : con1) {
-				vec1.push_back(item);
-			}
-			for (auto& item : con2) {
-				vec2.push_back(item);
-			}
-			std::sort(vec1.begin(), vec1.end());
-			std::sort(vec2.begin(), vec2.end());
-			return vec1 == vec2;
-		}
 		void testCase1() {
 			stdUst<int> ust1(10);
 			tsUst<int> ust2(10);
-			assert(container_equal(ust1, ust2));
+			assert(Test::unordered_container_equal(ust1, ust2));
 
 			int arr[] = { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
 			stdUst<int> ust3(std::begin(arr), std::end(arr));
 			tsUst<int> ust4(std::begin(arr), std::end(arr));
-			assert(container_equal(ust3, ust4));
+			assert(Test::unordered_container_equal(ust3, ust4));
 
 			auto ust5(ust3);
 			auto ust6(ust4);
-			assert(container_equal(ust5, ust6));
+			assert(Test::unordered_container_equal(ust5, ust6));
 
 			auto ust7 = ust3;
 			auto ust8 = ust4;
-			assert(container_equal(ust7, ust8));
+			assert(Test::unordered_container_equal(ust7, ust8));
 		}
 		void testCase2() {
 			tsUst<int> ust1(10);
@@ -52,7 +39,7 @@ namespace miniSTL {
 				ust1.insert(n);
 				ust2.insert(n);
 			}
-			assert(container_equal(ust1, ust2));
+			assert(Test::unordered_container_equal(ust1, ust2));
 
 			tsUst<int> ust3(10);
 			stdUst<int> ust4(10);
@@ -60,7 +47,7 @@ namespace miniSTL {
 			std::generate(v.begin(), v.end(), [&rd]() {return rd() % 65536; });
 			ust3.insert(v.begin(), v.end());
 			ust4.insert(v.begin(), v.end());
-			assert(container_equal(ust3, ust4));
+			assert(Test::unordered_container_equal(ust3, ust4));
 		}
 		void testCase4() {
 			int arr[] = { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
@@ -74,7 +61,7 @@ namespace miniSTL {
 			auto it = ust2.find(7);
 			it = ust2.erase(it);
 			assert(it != ust2.end());
-			assert(container_equal(ust1, ust2));
+			assert(Test::unordered_container_equal(ust1, ust2));
 		}
 		void testCase5() {
 			int arr[] = { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 7, 8, 9 };
@@ -83,6 +70,493 @@ namespace miniSTL {
 			assert(ust.find(0) != ust.end());
 			assert(ust.count(10) == 0);
 		}
+		struct Name {
+			std::string s;
+			explicit Name(const std::string& str) : s(str) {}
+			bool operator == (const Name& rhs) const { return s == rhs.s; }
+		};
+		struct NameHash {
+			size_t operator()(const Name& n) const { return std::hash<std::string>()(n.s); }
+		};
+		void testCase6() {
+			//keys without a default constructor, every bucket is a single pointer
+			miniSTL::Unordered_set<Name, NameHash> ust(10);
+			for (auto i = 0; i != 200; ++i)
+				assert(ust.insert(Name(std::to_string(i))).second);
+			assert(!ust.insert(Name("7")).second);
+			assert(ust.size() == 200);
+
+			size_t total = 0;
+			for (size_t i = 0; i != ust.bucket_count(); ++i) {
+				size_t n = 0;
+				for (auto it = ust.begin(i); it != ust.end(i); ++it, ++n)
+					assert(ust.bucket(*it) == i);
+				assert(n == ust.bucket_size(i));
+				total += n;
+			}
+			assert(total == 200);
+
+			auto copy = ust;
+			for (auto i = 0; i != 200; i += 2)
+				assert(ust.erase(Name(std::to_string(i))) == 1);
+			assert(ust.size() == 100 && copy.size() == 200);
+			for (auto i = 0; i != 200; ++i) {
+				assert(ust.count(Name(std::to_string(i))) == (i % 2 ? 1 : 0));
+				assert(copy.count(Name(std::to_string(i))) == 1);
+			}
+
+			copy = ust;
+			assert(copy.size() == 100);
+			size_t visited = 0;
+			for (auto it = copy.begin(); it != copy.end(); ++it)
+				++visited;
+			assert(visited == 100);
+			const auto& ccopy = copy;
+			for (auto it = ccopy.begin(); it != ccopy.end(); ++it)
+				assert(ust.count(*it) == 1);
+			ust.clear();
+			assert(ust.empty() && ust.begin() == ust.end());
+		}
+		void testCase7() {
+			//rehash relinks the nodes, keys stay where they were allocated
+			tsUst<std::string> ust1(10);
+			tsUst<int> ust2(10);
+			std::vector<const std::string*> addr1;
+			std::vector<const int*> addr2;
+			for (auto i = 0; i != 100; ++i) {
+				addr1.push_back(&*ust1.insert(std::to_string(i)).first);
+				addr2.push_back(&*ust2.insert(i).first);
+			}
+			ust1.max_load_factor(2.0f);
+			ust1.rehash(5000);
+			ust2.rehash(5000);
+			assert(ust1.bucket_count() >= 5000 && ust2.bucket_count() >= 5000);
+			assert(ust1.max_load_factor() == 2.0f);
+			assert(ust1.size() == 100 && ust2.size() == 100);
+			for (auto i = 0; i != 100; ++i) {
+				assert(&*ust1.find(std::to_string(i)) == addr1[i]);
+				assert(&*ust2.find(i) == addr2[i]);
+			}
+			size_t visited = 0;
+			for (auto it = ust2.begin(); it != ust2.end(); ++it)
+				++visited;
+			assert(visited == 100);
+		}
+		void testCase8() {
+			//incremental rehash, lookups see both tables while the old one drains
+			tsUst<int> ust(10);
+			stdUst<int> std_ust;
+			ust.incremental_rehash(true);
+			bool sawMigration = false;
+			for (auto i = 0; i != 20000; ++i) {
+				ust.insert(i);
+				std_ust.insert(i);
+				if (ust.rehashing()) {
+					sawMigration = true;
+					assert(ust.count(i / 2) == std_ust.count(i / 2));
+					assert(ust.count(-i - 1) == 0);
+				}
+				if (i % 3 == 0) {
+					assert(ust.erase(i) == 1);
+					std_ust.erase(i);
+				}
+			}
+			assert(sawMigration);
+			assert(ust.size() == std_ust.size());
+			assert(Test::unordered_container_equal(ust, std_ust));
+
+			//copy and erase through iterators in the middle of a migration
+			tsUst<int> ust2(10);
+			ust2.incremental_rehash(true);
+			auto i = 0;
+			while (!ust2.rehashing())
+				ust2.insert(i++);
+			ust2.insert(i++);
+			auto copy = ust2;
+			assert(copy.rehashing() && copy.size() == ust2.size());
+			for (auto it = copy.begin(); it != copy.end();) {
+				if (*it % 2)
+					it = copy.erase(it);
+				else
+					++it;
+			}
+			for (auto k = 0; k != i; ++k)
+				assert(copy.count(k) == (k % 2 ? 0 : 1));
+			ust2.incremental_rehash(false);
+			assert(!ust2.rehashing() && ust2.size() == static_cast<size_t>(i));
+			for (auto k = 0; k != i; ++k)
+				assert(ust2.count(k) == 1);
+		}
+		template<class Set>
+		void checkPolicy() {
+			Set ust(10);
+			stdUst<int> std_ust;
+			std::mt19937 gen(3);
+			for (auto i = 0; i != 20000; ++i) {
+				int n = gen() % 30000;
+				assert(ust.insert(n).second == std_ust.insert(n).second);
+				if (i % 4 == 0) {
+					int m = gen() % 30000;
+					assert(ust.erase(m) == std_ust.erase(m));
+				}
+			}
+			assert(ust.size() == std_ust.size());
+			assert(Test::unordered_container_equal(ust, std_ust));
+			for (size_t i = 0; i != ust.bucket_count(); ++i) {
+				for (auto it = ust.begin(i); it != ust.end(i); ++it)
+					assert(ust.bucket(*it) == i);
+			}
+		}
+		void testCase9() {
+			checkPolicy<tsUst<int>>();
+			checkPolicy<tsUstPow2<int>>();
+			checkPolicy<tsUstFastmod<int>>();
+
+			tsUstPow2<int> ust(100);
+			assert(ust.bucket_count() == 128);
+
+			//fastmod must agree with the modulo it replaces
+			miniSTL::fastmod_bucket_policy fastmod;
+			miniSTL::prime_bucket_policy prime;
+			std::mt19937 gen(5);
+			for (auto count : { 53u, 12289u, 4294967291u }) {
+				fastmod.reset(count);
+				prime.reset(count);
+				for (auto i = 0; i != 1000; ++i) {
+					size_t h = gen();
+					assert(fastmod.index(h) == prime.index(h));
+				}
+			}
+		}
+
+		void testCase10() {
+			miniSTL::Unordered_set<std::string, Test::SpanHash, Test::SpanEqual> ust(10, Test::SpanHash(42));
+			assert(ust.hash_function().seed == 42);
+			for (auto i = 0; i != 100; ++i)
+				ust.insert(std::to_string(i));
+
+			assert(ust.find(Test::CharSpan("17")) != ust.end());
+			assert(*ust.find(Test::CharSpan("17")) == "17");
+			assert(ust.find(Test::CharSpan("170")) == ust.end());
+			assert(ust.count(Test::CharSpan("99")) == 1);
+			assert(ust.erase(Test::CharSpan("99")) == 1);
+			assert(ust.erase(Test::CharSpan("99")) == 0);
+			assert(ust.size() == 99);
+
+			//hash once, probe two sets sharing the hasher
+			auto copy = ust;
+			assert(copy.hash_function().seed == 42);
+			copy.erase(std::string("5"));
+			size_t h = ust.hash_function()(Test::CharSpan("5"));
+			assert(ust.count(Test::CharSpan("5"), h) == 1);
+			assert(copy.count(Test::CharSpan("5"), h) == 0);
+			std::string key("6");
+			h = ust.hash_function()(key);
+			assert(ust.find(key, h) != ust.end() && copy.find(key, h) != copy.end());
+		}
+
+		void testCase11() {
+			std::mt19937 gen(11);
+			std::vector<int> keys;
+			for (auto i = 0; i != 1000; ++i)
+				keys.push_back(gen() % 3000);
+
+			for (auto incremental : { false, true }) {
+				tsUst<int> ust(10);
+				ust.incremental_rehash(incremental);
+				for (auto i = 0; i != 1500; ++i)
+					ust.insert(static_cast<int>(gen() % 3000));
+				if (incremental)
+					ust.rehash(ust.bucket_count() * 4);
+
+				std::vector<tsUst<int>::iterator> its;
+				ust.find_batch(keys.begin(), keys.end(), std::back_inserter(its));
+				std::vector<bool> has;
+				ust.contains_batch(keys.begin(), keys.end(), std::back_inserter(has));
+				assert(its.size() == keys.size() && has.size() == keys.size());
+
+				size_t hits = 0;
+				for (size_t i = 0; i != keys.size(); ++i) {
+					bool present = ust.count(keys[i]) == 1;
+					hits += present;
+					assert(has[i] == present);
+					assert(present ? *its[i] == keys[i] : its[i] == ust.end());
+				}
+				assert(ust.count_batch(keys.begin(), keys.end()) == hits);
+				assert(ust.count_batch(keys.begin(), keys.begin()) == 0);
+			}
+		}
+
+		void testCase12() {
+			tsUst<int> ust1(10);
+			ust1.reserve(1000);
+			auto buckets = ust1.bucket_count();
+			assert(buckets >= 1000);
+			for (auto i = 0; i != 1000; ++i)
+				ust1.insert(i);
+			assert(ust1.bucket_count() == buckets);
+
+			//a forward range is counted once and built without growing
+			std::list<int> lst;
+			for (auto i = 0; i != 5000; ++i)
+				lst.push_back(i % 3000);
+			tsUst<int> ust2(lst.begin(), lst.end());
+			stdUst<int> ust3(lst.begin(), lst.end());
+			assert(ust2.size() == 3000);
+			assert(ust2.bucket_count() == miniSTL::prime_bucket_policy::next_size(5000));
+			assert(Test::unordered_container_equal(ust2, ust3));
+
+			//range insert into a filled set, some keys already present
+			tsUstPow2<int> ust4(lst.begin(), lst.end());
+			std::vector<int> more;
+			for (auto i = 2000; i != 9000; ++i)
+				more.push_back(i);
+			ust4.insert(more.begin(), more.end());
+			ust3.insert(more.begin(), more.end());
+			assert(ust4.size() == 9000);
+			assert(Test::unordered_container_equal(ust4, ust3));
+
+			//a single pass range falls back to one insert per key
+			std::istringstream in("3 1 4 1 5 9 2 6 5 3 5");
+			tsUst<int> ust5((std::istream_iterator<int>(in)), std::istream_iterator<int>());
+			assert(ust5.size() == 7);
+			assert(ust5.count(9) == 1 && ust5.count(7) == 0);
+		}
+
+		void testCase13() {
+			//a sparse table, iteration visits only the few occupied buckets
+			tsUst<int> ust1(100000);
+			ust1.insert(3);
+			ust1.insert(77777);
+			size_t n = 0;
+			for (auto& k : ust1)
+				n += k == 3 || k == 77777;
+			assert(n == 2);
+			ust1.erase(3);
+			ust1.erase(77777);
+			assert(ust1.begin() == ust1.end());
+
+			//random inserts and erases, with and without a migration in flight
+			std::mt19937 gen(13);
+			for (auto incremental : { false, true }) {
+				tsUst<int> ust2(10);
+				stdUst<int> ust3;
+				ust2.incremental_rehash(incremental);
+				for (auto round = 0; round != 20; ++round) {
+					for (auto i = 0; i != 500; ++i) {
+						int k = gen() % 5000;
+						ust2.insert(k);
+						ust3.insert(k);
+					}
+					for (auto i = 0; i != 300; ++i) {
+						int k = gen() % 5000;
+						assert(ust2.erase(k) == ust3.erase(k));
+					}
+					assert(Test::unordered_container_equal(ust2, ust3));
+				}
+				auto ust4 = ust2;
+				ust2.clear();
+				assert(ust2.begin() == ust2.end() && ust2.size() == 0);
+				assert(Test::unordered_container_equal(ust4, ust3));
+				ust2.insert(42);
+				assert(*ust2.begin() == 42 && ++ust2.begin() == ust2.end());
+			}
+		}
+
+		void testCase14() {
+			//shrink_to_fit trims an over reserved table and keeps every key
+			tsUst<int> ust1(10);
+			ust1.reserve(100000);
+			for (auto i = 0; i != 1000; ++i)
+				ust1.insert(i);
+			auto big = ust1.bucket_count();
+			ust1.shrink_to_fit();
+			assert(ust1.bucket_count() < big && ust1.bucket_count() >= 1000);
+			assert(ust1.load_factor() <= ust1.max_load_factor());
+			for (auto i = 0; i != 1000; ++i)
+				assert(ust1.count(i) == 1);
+			ust1.clear();
+			ust1.shrink_to_fit();
+			assert(ust1.bucket_count() == tsUst<int>(0).bucket_count());
+
+			//the minimum is capped, and follows a lowered maximum
+			tsUst<int> ust2(10);
+			ust2.min_load_factor(0.5f);
+			assert(ust2.min_load_factor() == ust2.max_load_factor() / 8);
+			ust2.max_load_factor(0.5f);
+			assert(ust2.min_load_factor() == 0.5f / 8);
+			ust2.max_load_factor(1.0f);
+
+			//erasing by key shrinks a sparse table, alternating at the boundary does not flap
+			for (auto incremental : { false, true }) {
+				tsUstPow2<int> ust3(10);
+				stdUst<int> ust4;
+				ust3.incremental_rehash(incremental);
+				ust3.min_load_factor(0.1f);
+				for (auto i = 0; i != 50000; ++i) {
+					ust3.insert(i);
+					ust4.insert(i);
+				}
+				auto peak = ust3.bucket_count();
+				for (auto i = 0; i < 50000; i += 2) {
+					assert(ust3.erase(i) == ust4.erase(i));
+					assert(ust3.load_factor() >= ust3.min_load_factor() || ust3.bucket_count() <= 16);
+				}
+				for (auto i = 1; i < 49000; i += 2) {
+					ust3.erase(i);
+					ust4.erase(i);
+				}
+				assert(ust3.bucket_count() < peak / 8);
+				assert(Test::unordered_container_equal(ust3, ust4));
+
+				auto buckets = ust3.bucket_count();
+				for (auto round = 0; round != 1000; ++round) {
+					ust3.insert(-1);
+					ust3.erase(-1);
+				}
+				assert(ust3.bucket_count() == buckets);
+
+				//erase(iterator) never rebuilds, so a full sweep stays valid
+				for (auto it = ust3.begin(); it != ust3.end();)
+					it = ust3.erase(it);
+				assert(ust3.size() == 0 && ust3.bucket_count() == buckets);
+			}
+		}
+
+		//counts the key comparisons made, to see how many misses reach a chain
+		struct CountingEqual {
+			static size_t calls;
+			bool operator()(int a, int b) const { ++calls; return a == b; }
+		};
+		size_t CountingEqual::calls = 0;
+
+		void testCase15() {
+			//the filter never hides a key, whatever inserts, erases and rehashes came before
+			std::mt19937 gen(15);
+			for (auto incremental : { false, true }) {
+				tsUst<int> ust1(10);
+				stdUst<int> ust2;
+				ust1.incremental_rehash(incremental);
+				ust1.bloom_filter(true);
+				assert(ust1.bloom_filter());
+				for (auto round = 0; round != 20; ++round) {
+					for (auto i = 0; i != 1000; ++i) {
+						int k = gen() % 20000;
+						assert(ust1.insert(k).second == ust2.insert(k).second);
+					}
+					for (auto i = 0; i != 700; ++i) {
+						int k = gen() % 20000;
+						assert(ust1.erase(k) == ust2.erase(k));
+					}
+					for (auto i = 0; i != 20000; ++i)
+						assert(ust1.count(i) == ust2.count(i));
+				}
+				std::vector<int> probes;
+				for (auto i = 0; i != 20000; ++i)
+					probes.push_back(i);
+				assert(ust1.count_batch(probes.begin(), probes.end()) == ust2.size());
+
+				auto ust3 = ust1;
+				ust1.shrink_to_fit();
+				assert(Test::unordered_container_equal(ust1, ust2) && Test::unordered_container_equal(ust3, ust2));
+				for (auto k : ust2)
+					assert(ust1.count(k) == 1 && ust3.count(k) == 1);
+				ust1.clear();
+				assert(ust1.bloom_filter() && ust1.count(*ust2.begin()) == 0);
+				ust1.insert(7);
+				assert(ust1.count(7) == 1);
+			}
+
+			//switched on over existing keys, and off again
+			tsUst<int> ust4(10);
+			for (auto i = 0; i != 1000; ++i)
+				ust4.insert(i);
+			ust4.bloom_filter(true);
+			for (auto i = 0; i != 2000; ++i)
+				assert(ust4.count(i) == (i < 1000 ? 1 : 0));
+			ust4.bloom_filter(false);
+			assert(!ust4.bloom_filter() && ust4.count(999) == 1);
+
+			//misses rarely get past the filter to compare keys
+			miniSTL::Unordered_set<int, std::hash<int>, CountingEqual> ust5(10), ust6(10);
+			ust6.bloom_filter(true);
+			for (auto i = 0; i != 10000; ++i) {
+				ust5.insert(i * 2);
+				ust6.insert(i * 2);
+			}
+			CountingEqual::calls = 0;
+			for (auto i = 0; i != 10000; ++i)
+				assert(ust5.count(i * 2 + 1) == 0);
+			auto unfiltered = CountingEqual::calls;
+			CountingEqual::calls = 0;
+			for (auto i = 0; i != 10000; ++i)
+				assert(ust6.count(i * 2 + 1) == 0);
+			assert(CountingEqual::calls * 10 < unfiltered);
+		}
+
+		void testCase16() {
+			std::mt19937 gen(16);
+			for (auto incremental : { false, true }) {
+				for (auto filtered : { false, true }) {
+					tsUst<std::string> ust1(10), ust2(10);
+					stdUst<std::string> std1, std2;
+					ust1.incremental_rehash(incremental);
+					ust2.incremental_rehash(incremental);
+					ust1.bloom_filter(filtered);
+					for (auto i = 0; i != 3000; ++i) {
+						auto k1 = std::to_string(gen() % 6000), k2 = std::to_string(gen() % 6000);
+						ust1.insert(k1);
+						std1.insert(k1);
+						ust2.insert(k2);
+						std2.insert(k2);
+					}
+
+					stdUst<std::string> both, onlyFirst, all(std1);
+					for (auto& k : std1)
+						(std2.count(k) ? both : onlyFirst).insert(k);
+					all.insert(std2.begin(), std2.end());
+
+					for (auto threads : { 1, 4 }) {
+						auto inter1 = ust1.intersect(ust2, threads), inter2 = ust2.intersect(ust1, threads);
+						assert(Test::unordered_container_equal(inter1, both) && Test::unordered_container_equal(inter2, both));
+						auto diff = ust1.difference(ust2, threads);
+						assert(Test::unordered_container_equal(diff, onlyFirst));
+						for (auto& k : both)
+							assert(inter1.count(k) == 1 && diff.count(k) == 0);
+						auto uni = ust1;
+						ust2.union_into(uni, threads);
+						assert(Test::unordered_container_equal(uni, all));
+						for (auto& k : all)
+							assert(uni.count(k) == 1);
+					}
+					assert(Test::unordered_container_equal(ust1, std1) && Test::unordered_container_equal(ust2, std2));
+
+					//merge relinks the very same nodes, the duplicates stay behind
+					const std::string* moved = &*ust2.begin();
+					bool movedIsNew = std1.count(*moved) == 0;
+					ust1.merge(ust2);
+					assert(Test::unordered_container_equal(ust1, all));
+					for (auto& k : all)
+						assert(ust1.count(k) == 1);
+					assert(ust2.size() == both.size());
+					for (auto& k : both)
+						assert(ust2.count(k) == 1);
+					if (movedIsNew)
+						assert(&*ust1.find(*moved) == moved);
+					ust1.merge(ust1);
+					assert(ust1.size() == all.size());
+				}
+			}
+
+			//an empty side
+			tsUst<int> empty(10), some(10);
+			for (auto i = 0; i != 100; ++i)
+				some.insert(i);
+			assert(empty.intersect(some).size() == 0 && some.intersect(empty).size() == 0);
+			assert(some.difference(empty).size() == 100 && empty.difference(some).size() == 0);
+			empty.merge(some);
+			assert(empty.size() == 100 && some.size() == 0 && some.begin() == some.end());
+		}
 
 		void testAllCases() {
 			testCase1();
@@ -90,6 +564,17 @@ namespace miniSTL {
 			testCase3();
 			testCase4();
 			testCase5();
+			testCase6();
+			testCase7();
+			testCase8();
+			testCase9();
+			testCase10();
+			testCase11();
+			testCase12();
+			testCase13();
+			testCase14();
+			testCase15();
+			testCase16();
 		}
 	}
 }
\ No newline at end of file
@@ -8,7 +8,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <iterator>
+#include <list>
 #include <random>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -18,12 +22,27 @@ namespace miniSTL {
 		using stdUst = std::unordered_set <T>;
 		template<class T>
 		using tsUst = miniSTL::Unordered_set <T>;
+		template<class T>
+		using tsUstPow2 = miniSTL::Unordered_set <T, std::hash<T>, miniSTL::equal_to<T>, miniSTL::allocator<T>, miniSTL::pow2_bucket_policy>;
+		template<class T>
+		using tsUstFastmod = miniSTL::Unordered_set <T, std::hash<T>, miniSTL::equal_to<T>, miniSTL::allocator<T>, miniSTL::fastmod_bucket_policy>;
 
 		void testCase1();
 		void testCase2();
 		void testCase3();
 		void testCase4();
 		void testCase5();
+		void testCase6();
+		void testCase7();
+		void testCase8();
+		void testCase9();
+		void testCase10();
+		void testCase11();
+		void testCase12();
+		void testCase13();
+		void testCase14();
+		void testCase15();
+		void testCase16();
 
 		void testAllCases();
 	}
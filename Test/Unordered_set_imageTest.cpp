@@ -0,0 +1,110 @@
+#include "Unordered_set_imageTest.h"
+
+namespace miniSTL {
+	namespace Unordered_set_imageTest {
+		//the bytes of an image in a buffer aligned like a mapping
+		std::vector<uint64_t> toBuffer(const std::string& bytes) {
+			std::vector<uint64_t> buf(bytes.size() / sizeof(uint64_t) + 1);
+			memcpy(&buf[0], bytes.data(), bytes.size());
+			return buf;
+		}
+
+		void testCase1() {
+			tsUst<int> ust(10);
+			std::mt19937 gen(1);
+			for (auto i = 0; i != 20000; ++i)
+				ust.insert(static_cast<int>(gen() % 100000));
+
+			const tsUst<int>& cust = ust;
+			std::ostringstream out;
+			assert(tsImage<int>::write(out, cust));
+			std::string bytes = out.str();
+			auto buf = toBuffer(bytes);
+			tsImage<int> image(&buf[0], bytes.size());
+			assert(image.valid() && image.size() == ust.size());
+			assert(image.load_factor() <= 4.0f);
+			for (auto i = 0; i != 100000; ++i) {
+				assert(image.count(i) == ust.count(i));
+				if (ust.count(i))
+					assert(*image.find(i) == i);
+				else
+					assert(image.find(i) == image.end());
+			}
+			size_t n = 0;
+			for (auto& k : image)
+				n += ust.count(k);
+			assert(n == ust.size());
+		}
+
+		//a plain range, duplicates dropped, an empty range and other policies
+		void testCase2() {
+			std::vector<long long> keys;
+			for (auto i = 0; i != 3000; ++i)
+				keys.push_back(i % 1000 * 7);
+			std::ostringstream out;
+			assert(tsImagePow2<long long>::write(out, keys.begin(), keys.end(), 1.0f));
+			std::string bytes = out.str();
+			auto buf = toBuffer(bytes);
+			tsImagePow2<long long> image(&buf[0], bytes.size());
+			assert(image.valid() && image.size() == 1000);
+			assert(image.bucket_count() == miniSTL::pow2_bucket_policy::next_size(keys.size()));
+			for (auto i = 0; i != 7000; ++i)
+				assert(image.count(i) == (i % 7 == 0 ? 1 : 0));
+
+			std::vector<int> none;
+			std::ostringstream out2;
+			assert(tsImage<int>::write(out2, none.begin(), none.end()));
+			std::string bytes2 = out2.str();
+			auto buf2 = toBuffer(bytes2);
+			tsImage<int> empty(&buf2[0], bytes2.size());
+			assert(empty.valid() && empty.empty() && empty.count(0) == 0);
+
+			std::ostringstream out3;
+			assert(!tsImage<int>::write(out3, none.begin(), none.end(), 0.0f));
+			assert(!tsImagePow2<long long>::write(out3, keys.begin(), keys.end(), -1.0f));
+			assert(out3.str().empty());
+
+			//damaged or foreign images are refused, and still answer lookups with end()
+			tsImage<int> wrongKey(&buf[0], bytes.size());
+			assert(!wrongKey.valid() && wrongKey.count(0) == 0 && wrongKey.begin() == wrongKey.end());
+			tsImagePow2<long long> truncated(&buf[0], bytes.size() - 1);
+			assert(!truncated.valid());
+			tsImage<long long> wrongPolicy(&buf[0], bytes.size());
+			assert(!wrongPolicy.valid());
+			buf[0] ^= 1;
+			tsImagePow2<long long> badMagic(&buf[0], bytes.size());
+			assert(!badMagic.valid());
+		}
+
+		//through a file mapped read-only
+		void testCase3() {
+			const char* path = "Unordered_set_imageTest.tmp";
+			tsUst<unsigned> ust(10);
+			for (unsigned i = 0; i != 50000; ++i)
+				ust.insert(i * 2654435761u);
+			{
+				std::ofstream file(path, std::ios::binary);
+				assert(tsImage<unsigned>::write(file, ust));
+			}
+			{
+				miniSTL::Mapped_file file(path);
+				assert(file.is_open());
+				tsImage<unsigned> image(file.data(), file.size());
+				assert(image.valid() && image.size() == 50000);
+				for (unsigned i = 0; i != 50000; ++i) {
+					assert(image.count(i * 2654435761u) == 1);
+					assert(image.count(i * 2654435761u + 1) == ust.count(i * 2654435761u + 1));
+				}
+			}
+			std::remove(path);
+			miniSTL::Mapped_file missing(path);
+			assert(!missing.is_open() && missing.data() == nullptr);
+		}
+
+		void testAllCases() {
+			testCase1();
+			testCase2();
+			testCase3();
+		}
+	}
+}
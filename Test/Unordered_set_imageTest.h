@@ -0,0 +1,38 @@
+#ifndef _UNORDERED_SET_IMAGE_TEST_H_
+#define _UNORDERED_SET_IMAGE_TEST_H_
+
+#include "TestUtil.h"
+
+#include "..\Mapped_file.h"
+#include "..\Unordered_set_image.h"
+#include <unordered_set>
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace miniSTL {
+	namespace Unordered_set_imageTest {
+		template<class T>
+		using stdUst = std::unordered_set <T>;
+		template<class T>
+		using tsUst = miniSTL::Unordered_set <T>;
+		template<class T>
+		using tsImage = miniSTL::Unordered_set_image <T>;
+		template<class T>
+		using tsImagePow2 = miniSTL::Unordered_set_image <T, std::hash<T>, miniSTL::equal_to<T>, miniSTL::pow2_bucket_policy>;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+
+		void testAllCases();
+	}
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include "Unrolled_listTest.h"
+
+namespace miniSTL {
+	namespace Unrolled_listTest {
+		void testCase1() {
+			stdL<int> l1(10, 0);
+			tsL<int> l2(10, 0);
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			int arr[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+			stdL<int> l3(std::begin(arr), std::end(arr));
+			tsL<int> l4(std::begin(arr), std::end(arr));
+			assert(miniSTL::Test::container_equal(l3, l4));
+
+			auto l5(l4);
+			assert(l5 == l4);
+
+			tsL<int> l6;
+			l6 = l4;
+			assert(l6 == l4);
+			assert(l6.size() == 9);
+		}
+		void testCase2() {
+			stdL<std::string> l1;
+			tsL<std::string> l2;
+			for (auto i = 0; i != 20; ++i) {
+				l1.push_front(std::to_string(i));
+				l2.push_front(std::to_string(i));
+				l1.push_back(std::to_string(-i));
+				l2.push_back(std::to_string(-i));
+			}
+			assert(miniSTL::Test::container_equal(l1, l2));
+			assert(l1.front() == l2.front() && l1.back() == l2.back());
+
+			for (auto i = 0; i != 7; ++i) {
+				l1.pop_front(); l1.pop_back();
+				l2.pop_front(); l2.pop_back();
+			}
+			assert(miniSTL::Test::container_equal(l1, l2));
+			assert(l1.size() == l2.size());
+		}
+		void testCase3() {
+			stdL<int> l1;
+			tsL<int> l2;
+			std::mt19937 gen(42);
+			for (auto i = 0; i != 500; ++i) {
+				size_t pos = gen() % (l1.size() + 1);
+				auto it1 = l1.begin();
+				auto it2 = l2.begin();
+				for (size_t j = 0; j != pos; ++j) {
+					++it1;
+					++it2;
+				}
+				l1.insert(it1, i);
+				l2.insert(it2, i);
+			}
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			for (auto i = 0; i != 400; ++i) {
+				size_t pos = gen() % l1.size();
+				auto it1 = l1.begin();
+				auto it2 = l2.begin();
+				for (size_t j = 0; j != pos; ++j) {
+					++it1;
+					++it2;
+				}
+				it1 = l1.erase(it1);
+				it2 = l2.erase(it2);
+				assert((it1 == l1.end()) == (it2 == l2.end()));
+				if (it1 != l1.end())
+					assert(*it1 == *it2);
+			}
+			assert(miniSTL::Test::container_equal(l1, l2));
+			assert(l1.size() == l2.size());
+		}
+		void testCase4() {
+			stdL<int> l1(10, 0), l3(10, 1);
+			tsL<int> l2(10, 0), l4(10, 1);
+
+			auto it1 = l1.begin();
+			auto it2 = l2.begin();
+			for (auto i = 0; i != 3; ++i) {
+				++it1;
+				++it2;
+			}
+			l1.splice(it1, l3);
+			l2.splice(it2, l4);
+			assert(miniSTL::Test::container_equal(l1, l2));
+			assert(l4.empty() && l2.size() == 20);
+
+			stdL<int> l5(5, 2);
+			tsL<int> l6(5, 2);
+			l1.splice(l1.end(), l5, l5.begin());
+			l2.splice(l2.end(), l6, l6.begin());
+			assert(miniSTL::Test::container_equal(l1, l2));
+			assert(miniSTL::Test::container_equal(l5, l6));
+
+			l1.splice(l1.begin(), l1, --l1.end(), l1.end());
+			l2.splice(l2.begin(), l2, --l2.end(), l2.end());
+			assert(miniSTL::Test::container_equal(l1, l2));
+		}
+		void testCase5() {
+			int arr1[] = { 0, 1, 3, 5, 9 }, arr2[] = { 2, 4, 6, 7, 8 };
+			stdL<int> first1(std::begin(arr1), std::end(arr1)), second1(std::begin(arr2), std::end(arr2));
+			tsL<int> first2(std::begin(arr1), std::end(arr1)), second2(std::begin(arr2), std::end(arr2));
+
+			first1.merge(second1);
+			first2.merge(second2);
+			assert(miniSTL::Test::container_equal(first1, first2));
+			assert(second2.empty() && first2.size() == 10);
+		}
+		void testCase6() {
+			stdL<int> l1;
+			tsL<int> l2;
+			std::mt19937 gen(7);
+			for (auto i = 0; i != 10000; ++i) {
+				auto n = static_cast<int>(gen() % 1000);
+				l1.push_back(n);
+				l2.push_back(n);
+			}
+			l1.sort();
+			l2.sort();
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			l1.sort(std::greater<int>());
+			l2.sort(std::greater<int>());
+			assert(miniSTL::Test::container_equal(l1, l2));
+			assert(l2.size() == 10000);
+		}
+		void testCase7() {
+			int arr[] = { 0, 0, 1, 2, 2, 3, 3, 4, 4, 4, 5, 5, 6, 7, 8, 8, 9, 11 };
+			stdL<int> l1(std::begin(arr), std::end(arr));
+			tsL<int> l2(std::begin(arr), std::end(arr));
+
+			l1.unique();
+			l2.unique();
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			l1.remove(8);
+			l2.remove(8);
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			auto func = [](int n) {return n % 2 == 0; };
+			l1.remove_if(func);
+			l2.remove_if(func);
+			assert(miniSTL::Test::container_equal(l1, l2));
+			assert(l1.size() == l2.size());
+		}
+		void testCase8() {
+			int arr[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+			stdL<int> l1(std::begin(arr), std::end(arr));
+			tsL<int> l2(std::begin(arr), std::end(arr));
+
+			l1.reverse();
+			l2.reverse();
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			tsL<int> l3(std::move(l2));
+			assert(l2.empty());
+			assert(miniSTL::Test::container_equal(l1, l3));
+
+			l2.swap(l3);
+			assert(l3.empty());
+			assert(miniSTL::Test::container_equal(l1, l2));
+
+			l2.erase(l2.begin(), l2.end());
+			assert(l2.empty() && l2.begin() == l2.end());
+		}
+
+		void testAllCases() {
+			testCase1();
+			testCase2();
+			testCase3();
+			testCase4();
+			testCase5();
+			testCase6();
+			testCase7();
+			testCase8();
+		}
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef _UNROLLED_LIST_TEST_H_
+#define _UNROLLED_LIST_TEST_H_
+
+#include "TestUtil.h"
+
+#include "../Unrolled_list.h"
+#include <list>
+
+#include <cassert>
+#include <functional>
+#include <string>
+#include <random>
+
+namespace miniSTL {
+	namespace Unrolled_listTest {
+		template<class T>
+		using stdL = std::list < T >;
+		template<class T>
+		using tsL = miniSTL::unrolled_list < T, 4 >;
+
+		void testCase1();
+		void testCase2();
+		void testCase3();
+		void testCase4();
+		void testCase5();
+		void testCase6();
+		void testCase7();
+		void testCase8();
+
+		void testAllCases();
+	}
+}
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef _UNORDERED_MAP_H_
+#define _UNORDERED_MAP_H_
+
+#include "Unordered_set.h"
+#include "Utility.h"
+
+#include <utility>
+
+namespace miniSTL
+{
+	/*
+	 * Unordered_map
+	 * the Unordered_set engine storing (key, mapped) pairs, hashed and compared by pair::first.
+	 * buckets, bucket policies, incremental rehash, batched and heterogeneous lookups all
+	 * behave as they do for the set. try_emplace and operator[] build the mapped value
+	 * in the node only when the key is absent.
+	 */
+	template <class Key, class T, class Hash = std::hash<Key>, class EqualKey = miniSTL::equal_to<Key>,
+	class Allocator = miniSTL::allocator<miniSTL::pair<const Key, T>>, class Policy = prime_bucket_policy>
+	class Unordered_map
+	{
+	public:
+		typedef Key key_type;
+		typedef T mapped_type;
+		typedef miniSTL::pair<const Key, T> value_type;
+		typedef size_t size_type;
+		typedef Hash haser;
+		typedef EqualKey equal_key;
+		typedef Allocator allocator_type;
+		typedef Policy bucket_policy;
+		typedef value_type& reference;
+		typedef const value_type& const_reference;
+
+	private:
+		typedef Unordered_set<value_type, Hash, EqualKey, Allocator, Policy, Detail::ust_select1st<value_type>> table_type;
+
+	public:
+		typedef typename table_type::iterator iterator;
+		typedef typename table_type::local_iterator local_iterator;
+
+	private:
+		table_type table_;
+
+	public:
+		explicit Unordered_map(size_type bucket_count, const haser& hash = haser(), const equal_key& equal = equal_key())
+			: table_(bucket_count, hash, equal) {}
+
+		template <class InputIterator>
+		Unordered_map(InputIterator first, InputIterator last) : table_(first, last) {}
+
+		size_type size()const { return table_.size(); }
+		bool empty()const { return table_.empty(); }
+
+		size_type bucket_count()const { return table_.bucket_count(); }
+		size_type bucket_size(size_type i)const { return table_.bucket_size(i); }
+		size_type bucket(const key_type& key)const { return table_.bucket(key); }
+
+		float load_factor()const { return table_.load_factor(); }
+		float max_load_factor()const { return table_.max_load_factor(); }
+		void max_load_factor(float z) { table_.max_load_factor(z); }
+		float min_load_factor()const { return table_.min_load_factor(); }
+		void min_load_factor(float z) { table_.min_load_factor(z); }
+
+		void rehash(size_type n) { table_.rehash(n); }
+		void reserve(size_type n) { table_.reserve(n); }
+		void shrink_to_fit() { table_.shrink_to_fit(); }
+
+		bool incremental_rehash()const { return table_.incremental_rehash(); }
+		void incremental_rehash(bool enable) { table_.incremental_rehash(enable); }
+		bool rehashing()const { return table_.rehashing(); }
+
+		iterator begin() { return table_.begin(); }
+		iterator end() { return table_.end(); }
+
+		local_iterator begin(size_type i) { return table_.begin(i); }
+		local_iterator end(size_type i) { return table_.end(i); }
+
+		iterator find(const key_type& key) { return table_.find(key); }
+		iterator find(const key_type& key, size_type hash) { return table_.find(key, hash); }
+		size_type count(const key_type& key) { return table_.count(key); }
+		size_type count(const key_type& key, size_type hash) { return table_.count(key, hash); }
+
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, iterator>::type find(const K& key) { return table_.find(key); }
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, iterator>::type find(const K& key, size_type hash) {
+			return table_.find(key, hash);
+		}
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, size_type>::type count(const K& key) { return table_.count(key); }
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, size_type>::type count(const K& key, size_type hash) {
+			return table_.count(key, hash);
+		}
+
+		template <class ForwardIterator, class OutputIterator>
+		OutputIterator find_batch(ForwardIterator first, ForwardIterator last, OutputIterator result) {
+			return table_.find_batch(first, last, result);
+		}
+		template <class ForwardIterator, class OutputIterator>
+		OutputIterator contains_batch(ForwardIterator first, ForwardIterator last, OutputIterator result) {
+			return table_.contains_batch(first, last, result);
+		}
+		template <class ForwardIterator>
+		size_type count_batch(ForwardIterator first, ForwardIterator last) { return table_.count_batch(first, last); }
+
+		//the mapped value of key, value initialized and inserted first if key is absent
+		mapped_type& operator[](const key_type& key);
+
+		miniSTL::pair<iterator, bool> insert(const value_type& val) { return table_.insert(val); }
+
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last) { table_.insert(first, last); }
+
+		//builds mapped_type from args only if key is absent, an existing entry is left untouched
+		template <class... Args>
+		miniSTL::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args);
+
+		//inserts (key, obj), or assigns obj to the mapped value of an existing key
+		template <class M>
+		miniSTL::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj);
+
+		iterator erase(iterator position) { return table_.erase(position); }
+		size_type erase(const key_type& key) { return table_.erase(key); }
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, size_type>::type erase(const K& key) { return table_.erase(key); }
+
+		//moves the entries of m whose keys are not here, the others stay in m
+		void merge(Unordered_map& m) { table_.merge(m.table_); }
+
+		haser hash_function()const { return table_.hash_function(); }
+		equal_key key_eq()const { return table_.key_eq(); }
+		allocator_type get_allocator()const { return allocator_type(); }
+
+		void swap(Unordered_map& m) { table_.swap(m.table_); }
+		void clear() { table_.clear(); }
+
+	public:
+		template<class K, class V, class H, class E, class A, class P>
+		friend void swap(Unordered_map<K, V, H, E, A, P>& lhs, Unordered_map<K, V, H, E, A, P>& rhs);
+	};
+}
+
+#include "Detail\Unordered_map.impl.h"
+#endif
@@ -5,84 +5,450 @@
 #include "Algorithm.h"
 #include "Functional.h"
 #include "Iterator.h"
-#include "List.h"
 #include "Vector.h"
 
-namespace miniSTL 
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace miniSTL
 {
-	template<class Key, class Hash, class EqualKey, class Allocator>
+	template<class Key, class Hash, class EqualKey, class Allocator, class Policy, class ExtractKey>
 	class Unordered_set;
+	template<class Key, class T, class Hash, class EqualKey, class Allocator, class Policy>
+	class Unordered_map;
 
 	namespace Detail
 	{
-		template<class Key, class ListIterator, class Hash = std::hash<Key>,
-			class EqualKey = miniSTL::equal_to<Key>, class Allocator = miniSTL::allocator<Key>>
+		//read the key out of a stored value, the set stores keys, the map stores (key, mapped) pairs
+		template <class Value>
+		struct ust_identity {
+			typedef Value key_type;
+
+			template <class V>
+			const V& operator()(const V& v) const { return v; }
+		};
+
+		template <class Pair>
+		struct ust_select1st {
+			typedef typename std::remove_const<typename Pair::first_type>::type key_type;
+
+			template <class P>
+			const typename P::first_type& operator()(const P& p) const { return p.first; }
+		};
+
+		//the bucket counts used by the prime policies, each roughly twice the previous one
+		template <class Dummy>
+		struct ust_prime_table {
+			static const int size = 28;
+			static const size_t list[size];
+
+			//smallest listed prime not below n
+			static size_t next(size_t n);
+		};
+
+		//high 64 bits of a 64 x 64 bit product
+		inline uint64_t ust_mulhi(uint64_t a, uint64_t b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+			return __umulh(a, b);
+#elif defined(__SIZEOF_INT128__)
+			return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+			uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32, bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+			uint64_t mid1 = aHi * bLo + ((aLo * bLo) >> 32);
+			uint64_t mid2 = aLo * bHi + (mid1 & 0xFFFFFFFF);
+			return aHi * bHi + (mid1 >> 32) + (mid2 >> 32);
+#endif
+		}
+
+		inline int ust_ctz(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+			unsigned long index;
+			_BitScanForward64(&index, x);
+			return static_cast<int>(index);
+#elif defined(_MSC_VER)
+			unsigned long index;
+			if (static_cast<uint32_t>(x) != 0)
+				_BitScanForward(&index, static_cast<uint32_t>(x));
+			else {
+				_BitScanForward(&index, static_cast<uint32_t>(x >> 32));
+				index += 32;
+			}
+			return static_cast<int>(index);
+#else
+			return __builtin_ctzll(x);
+#endif
+		}
+
+		/*
+		 * occupancy bitmap, one bit per bucket, set while the bucket is non-empty.
+		 * iteration and clear() jump from one occupied bucket to the next a word at a time
+		 * instead of loading every bucket pointer
+		 */
+		inline size_t ust_bitmap_words(size_t buckets) { return (buckets + 63) >> 6; }
+		template <class Bits>
+		inline void ust_bitmap_set(Bits& bits, size_t i) { bits[i >> 6] |= uint64_t(1) << (i & 63); }
+		template <class Bits>
+		inline void ust_bitmap_reset(Bits& bits, size_t i) { bits[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+
+		//first set bit at or after from, limit if there is none
+		template <class Bits>
+		inline size_t ust_bitmap_next(const Bits& bits, size_t from, size_t limit) {
+			if (from >= limit)
+				return limit;
+			size_t w = from >> 6;
+			const size_t words = ust_bitmap_words(limit);
+			uint64_t word = bits[w] & (~uint64_t(0) << (from & 63));
+			while (!word) {
+				if (++w == words)
+					return limit;
+				word = bits[w];
+			}
+			return (w << 6) + static_cast<size_t>(ust_ctz(word));
+		}
+
+		//hint that the line holding p is read soon, a no-op where the compiler offers no prefetch
+		inline void ust_prefetch(const void* p) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+			__builtin_prefetch(p);
+#else
+			(void)p;
+#endif
+		}
+
+		/*
+		 * split block Bloom filter: 32 byte blocks of eight 32-bit words, a key sets one bit in each
+		 * word of a single block, so adding or testing a key touches one block. the hash is remixed
+		 * first, std::hash of an integer is the integer and would crowd neighbouring keys together
+		 */
+		const size_t ust_bloom_block_words = 8;
+
+		inline uint64_t ust_bloom_mix(uint64_t h) {
+			h ^= h >> 33;
+			h *= 0xFF51AFD7ED558CCDULL;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ULL;
+			return h ^ (h >> 33);
+		}
+
+		//words for about n keys at 8 bits a key, never less than one block. a table is rarely full,
+		//so the keys actually present get more than that, and a smaller filter stays in cache
+		inline size_t ust_bloom_words(size_t n) {
+			size_t blocks = (n + 31) / 32;
+			return (blocks ? blocks : 1) * ust_bloom_block_words;
+		}
+
+		//first word of the block of h, the high half of h scaled onto the block count
+		template <class Filter>
+		inline size_t ust_bloom_block(const Filter& filter, uint64_t h) {
+			uint64_t blocks = static_cast<uint64_t>(filter.size()) / ust_bloom_block_words;
+			return static_cast<size_t>(((h >> 32) * blocks) >> 32) * ust_bloom_block_words;
+		}
+
+		//the bit of word i, from the low half of h times an odd salt per word
+		inline uint32_t ust_bloom_bit(uint64_t h, size_t i) {
+			static const uint32_t salt[ust_bloom_block_words] = {
+				0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du, 0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u
+			};
+			return uint32_t(1) << ((static_cast<uint32_t>(h) * salt[i]) >> 27);
+		}
+
+		template <class Filter>
+		inline void ust_bloom_add(Filter& filter, size_t hash) {
+			uint64_t h = ust_bloom_mix(hash);
+			uint32_t* block = &filter[ust_bloom_block(filter, h)];
+			for (size_t i = 0; i != ust_bloom_block_words; ++i)
+				block[i] |= ust_bloom_bit(h, i);
+		}
+
+		template <class Filter>
+		inline bool ust_bloom_test(const Filter& filter, size_t hash) {
+			uint64_t h = ust_bloom_mix(hash);
+			const uint32_t* block = &filter[ust_bloom_block(filter, h)];
+			//no early exit, the eight tests are independent and a branch per word would mispredict
+			uint32_t missing = 0;
+			for (size_t i = 0; i != ust_bloom_block_words; ++i)
+				missing |= ~block[i] & ust_bloom_bit(h, i);
+			return missing == 0;
+		}
+
+		template <class Filter>
+		inline void ust_bloom_prefetch(const Filter& filter, size_t hash) {
+			ust_prefetch(&filter[ust_bloom_block(filter, ust_bloom_mix(hash))]);
+		}
+	}
+
+	/*
+	 * bucket policies
+	 * a policy picks the bucket counts a table may have (next_size) and maps a hash
+	 * onto the current count (index), reset is called whenever the count changes.
+	 */
+
+	//prime bucket counts and hash % count, the original policy, tolerant of weak hashes
+	struct prime_bucket_policy {
+		size_t count_;
+
+		prime_bucket_policy() : count_(1) {}
+		static size_t next_size(size_t n) { return Detail::ust_prime_table<void>::next(n); }
+		void reset(size_t count) { count_ = count; }
+		size_t index(size_t hash) const { return hash % count_; }
+	};
+
+	//prime bucket counts, the modulo replaced by Lemire's fastmod: two multiplications, no division
+	struct fastmod_bucket_policy {
+		uint64_t magic_;
+		uint32_t count_;
+
+		fastmod_bucket_policy() : magic_(0), count_(1) {}
+		static size_t next_size(size_t n) { return Detail::ust_prime_table<void>::next(n); }
+		void reset(size_t count) {
+			count_ = static_cast<uint32_t>(count);
+			magic_ = UINT64_MAX / count_ + 1;
+		}
+		size_t index(size_t hash) const {
+			uint64_t h = static_cast<uint64_t>(hash);
+			uint32_t folded = static_cast<uint32_t>(h ^ (h >> 32));
+			return static_cast<size_t>(Detail::ust_mulhi(magic_ * folded, count_));
+		}
+	};
+
+	//power of two bucket counts, the hash goes through a finalizer mix so a mask can select the bucket
+	struct pow2_bucket_policy {
+		size_t mask_;
+
+		pow2_bucket_policy() : mask_(0) {}
+		static size_t next_size(size_t n) {
+			size_t count = 16;
+			while (count < n)
+				count <<= 1;
+			return count;
+		}
+		void reset(size_t count) { mask_ = count - 1; }
+		size_t index(size_t hash) const {
+			uint64_t h = static_cast<uint64_t>(hash);
+			h ^= h >> 33;
+			h *= 0xFF51AFD7ED558CCDULL;
+			h ^= h >> 33;
+			h *= 0xC4CEB9FE1A85EC53ULL;
+			h ^= h >> 33;
+			return static_cast<size_t>(h) & mask_;
+		}
+	};
+
+	namespace Detail
+	{
+		//nodes keep their hash unless Key is integral, where hashing again costs less than the extra word
+		template <class Key, class Hash>
+		struct ust_cache_hash : public std::integral_constant<bool, !std::is_integral<Key>::value> {};
+
+		//a bucket is a pointer to the first node of a null-terminated chain
+		struct ust_node_base {
+			ust_node_base* next;
+		};
+
+		template <class Key, bool CacheHash>
+		struct ust_node : public ust_node_base {
+			Key value;
+
+			template <class... Args>
+			explicit ust_node(Args&&... args) : value(std::forward<Args>(args)...) { next = nullptr; }
+		};
+
+		template <class Key>
+		struct ust_node<Key, true> : public ust_node_base {
+			size_t hash;
+			Key value;
+
+			template <class... Args>
+			explicit ust_node(Args&&... args) : hash(0), value(std::forward<Args>(args)...) { next = nullptr; }
+		};
+
+		//a hasher or key compare declaring is_transparent accepts any type comparable with Key
+		template <class T>
+		struct ust_void { typedef void type; };
+
+		template <class T, class = void>
+		struct ust_is_transparent : public std::false_type {};
+
+		template <class T>
+		struct ust_is_transparent<T, typename ust_void<typename T::is_transparent>::type> : public std::true_type {};
+
+		//enables the lookups taking a K when both Hash and EqualKey are transparent, K keeps the test dependent
+		template <class Hash, class EqualKey, class K, class R>
+		struct ust_enable_transparent
+			: public std::enable_if<ust_is_transparent<Hash>::value && ust_is_transparent<EqualKey>::value, R> {};
+
+		//how a range passed to the bulk insert may be walked, only a multi pass range is counted up front
+		struct ust_single_pass {};
+		struct ust_multi_pass {};
+		struct ust_random_access : public ust_multi_pass {};
+
+		//accepts the iterator tags of both this library and the standard one
+		template <class InputIterator>
+		struct ust_range_category {
+			typedef typename iterator_traits<InputIterator>::iterator_category category;
+			static const bool random = std::is_convertible<category, random_access_iterator_tag>::value ||
+				std::is_convertible<category, std::random_access_iterator_tag>::value;
+			static const bool forward = std::is_convertible<category, forward_iterator_tag>::value ||
+				std::is_convertible<category, std::forward_iterator_tag>::value;
+			typedef typename std::conditional<random, ust_random_access,
+				typename std::conditional<forward, ust_multi_pass, ust_single_pass>::type>::type type;
+		};
+
+		template <class InputIterator>
+		size_t ust_range_length(InputIterator first, InputIterator last, ust_multi_pass) {
+			size_t n = 0;
+			for (; first != last; ++first)
+				++n;
+			return n;
+		}
+
+		template <class InputIterator>
+		size_t ust_range_length(InputIterator first, InputIterator last, ust_random_access) {
+			return static_cast<size_t>(last - first);
+		}
+
+		//walks one bucket
+		template <class Key, bool CacheHash>
+		struct ust_local_iterator : public iterator<forward_iterator_tag, Key>
+		{
+		public:
+			typedef ust_node<Key, CacheHash>* nodeptr;
+
+			ust_node_base* node_;
+
+		public:
+			ust_local_iterator(ust_node_base* node = nullptr) : node_(node) {}
+
+			ust_local_iterator& operator++() { node_ = node_->next; return *this; }
+			ust_local_iterator operator++(int) { auto res = *this; node_ = node_->next; return res; }
+
+			Key& operator*() const { return static_cast<nodeptr>(node_)->value; }
+			Key* operator->() const { return &operator*(); }
+
+			bool operator == (const ust_local_iterator& it) const { return node_ == it.node_; }
+			bool operator != (const ust_local_iterator& it) const { return node_ != it.node_; }
+		};
+
+		//walks the chains bucket by bucket, end() has a null node
+		template<class Key, class Hash = std::hash<Key>, class EqualKey = miniSTL::equal_to<Key>,
+			class Allocator = miniSTL::allocator<Key>, class Policy = prime_bucket_policy, class ExtractKey = Detail::ust_identity<Key>,
+			class Ref = Key&, class Ptr = Key*>
 			class ust_iterator : public iterator<forward_iterator_tag, Key>
 		{
 		private:
-			template<class Key, class Hash, class EqualKey, class Allocator>
-			friend class Unordered_set;
+			template<class K, class H, class E, class A, class P, class X>
+			friend class miniSTL::Unordered_set;
+
+		public:
+			typedef Ref reference;
+			typedef Ptr pointer;
 
 		private:
-			typedef Unordered_set<Key, Hash, EqualKey, Allocator>* cntrPtr;
+			typedef const Unordered_set<Key, Hash, EqualKey, Allocator, Policy, ExtractKey>* cntrPtr;
+			typedef ust_node<Key, ust_cache_hash<typename ExtractKey::key_type, Hash>::value>* nodeptr;
 			size_t bucket_index_;
-			ListIterator iterator_;
+			ust_node_base* node_;
 			cntrPtr container_;
-			
+
 		public:
-			ust_iterator(size_t index, ListIterator it, cntrPtr ptr);
+			ust_iterator(size_t index, ust_node_base* node, cntrPtr ptr);
 			ust_iterator& operator++();
 			ust_iterator operator++(int);
 
-			Key& operator*() { return *iterator_; }
-			Key* operator->() { return &operator*(); }
+			Ref operator*() const { return static_cast<nodeptr>(node_)->value; }
+			Ptr operator->() const { return &operator*(); }
 
-		private:
-			template<class Key, class ListIterator, class Hash, class KeyEqual, class Allocator>
-			friend bool operator ==(const ust_iterator<Key, ListIterator, Hash, KeyEqual, Allocator>& lhs,
-				const ust_iterator<Key, ListIterator, Hash, KeyEqual, Allocator>& rhs);
-		
-			template<class Key, class ListIterator, class Hash, class KeyEqual, class Allocator>
-			friend bool operator !=(const ust_iterator<Key, ListIterator, Hash, KeyEqual, Allocator>& lhs,
-				const ust_iterator<Key, ListIterator, Hash, KeyEqual, Allocator>& rhs);
+			bool operator == (const ust_iterator& it) const { return node_ == it.node_; }
+			bool operator != (const ust_iterator& it) const { return node_ != it.node_; }
 		};
 	}
 
-	template <class Key, class Hash = std::hash<Key>,
-	class EqualKey = miniSTL::equal_to<Key>, class Allocator = miniSTL::allocator<Key>>
-	class Unordered_set 
+	/*
+	 * Unordered_set
+	 * separate chaining over one array of bucket pointers, each key lives in a singly linked node
+	 * drawn from the node pool of the allocator, so an empty bucket costs one pointer and one bit
+	 * of the occupancy bitmap, and Key needs no default constructor. the hash is cached in the node
+	 * for non-integral keys. iteration and clear() follow the bitmap, so a sparse table costs
+	 * size() plus bucket_count() / 64 word reads rather than a load per bucket.
+	 * Policy chooses bucket counts and how a hash selects a bucket, see the bucket policies above.
+	 * ExtractKey reads the key out of a stored Key, it is the identity for the set itself and
+	 * picks pair::first when Unordered_map stores its (key, mapped) pairs through this engine.
+	 */
+	template <class Key, class Hash = std::hash<Key>, class EqualKey = miniSTL::equal_to<Key>,
+	class Allocator = miniSTL::allocator<Key>, class Policy = prime_bucket_policy, class ExtractKey = Detail::ust_identity<Key>>
+	class Unordered_set
 	{
 	private:
-		template<class Key, class ListIterator, class Hash, class EqualKey, class Allocator>
+		template<class K, class H, class E, class A, class P, class X, class R, class Pt>
 		friend class Detail::ust_iterator;
+		template<class K, class T, class H, class E, class A, class P>
+		friend class Unordered_map;
+
+		static const bool cache_hash = Detail::ust_cache_hash<typename ExtractKey::key_type, Hash>::value;
+		typedef Detail::ust_node_base node_base;
+		typedef Detail::ust_node<Key, cache_hash> node;
+		typedef node* nodeptr;
+		//nodes and tables all come from Allocator, rebound to what they hold
+		typedef typename Allocator::template rebind<node>::other nodeAllocator;
+		typedef miniSTL::vector<node_base*, typename Allocator::template rebind<node_base*>::other> bucket_vector;
+		typedef miniSTL::vector<uint64_t, typename Allocator::template rebind<uint64_t>::other> bitmap_vector;
+		typedef miniSTL::vector<uint32_t, typename Allocator::template rebind<uint32_t>::other> filter_vector;
 
 	public:
-		typedef Key key_type;
+		typedef typename ExtractKey::key_type key_type;
 		typedef Key value_type;
 		typedef size_t size_type;
 		typedef Hash haser;
 		typedef EqualKey equal_key;
 		typedef Allocator allocator_type;
+		typedef Policy bucket_policy;
 		typedef value_type& reference;
 		typedef const value_type& const_reference;
-		typedef typename miniSTL::list<key_type>::iterator local_iterator;
-		typedef Detail::ust_iterator<Key, typename miniSTL::list<key_type>::iterator, Hash, EqualKey, Allocator> iterator;
-	
+		typedef Detail::ust_local_iterator<Key, cache_hash> local_iterator;
+		typedef Detail::ust_iterator<Key, Hash, EqualKey, Allocator, Policy, ExtractKey> iterator;
+		typedef Detail::ust_iterator<Key, Hash, EqualKey, Allocator, Policy, ExtractKey, const Key&, const Key*> const_iterator;
+
 	private:
-		miniSTL::vector<miniSTL::list<Key>> buckets_;
+		bucket_vector buckets_;
+		bucket_vector old_buckets_; //table being drained by an incremental rehash
+		bitmap_vector occupied_; //bitmap of the non-empty buckets_
+		bitmap_vector old_occupied_; //and of the non-empty old_buckets_
+		Policy policy_;
+		Policy old_policy_;
+		size_type migrate_index_; //old buckets below this index are already empty
 		size_type size_;
 		float max_load_factor_;
-		static const int PRIME_LIST_SIZE = 28;
-		static size_t prime_list_[PRIME_LIST_SIZE];
+		float min_load_factor_; //0 never shrinks
+		filter_vector filter_; //Bloom filter over every key, empty while switched off
+		filter_vector old_filter_; //still covers every key while a migration refills filter_
+		size_type filter_erased_; //keys erased since filter_ was filled, they still test positive
+		bool incremental_;
+		haser hash_;
+		equal_key equal_;
+		static const int REHASH_STEP = 8;
+		static const int BATCH_SIZE = 16;
 
 	public:
-		explicit Unordered_set(size_t bucket_count);
+		explicit Unordered_set(size_t bucket_count, const haser& hash = haser(), const equal_key& equal = equal_key());
 
+		//a forward range is counted first and the table sized once for it
 		template <class InputIterator>
 		Unordered_set(InputIterator first, InputIterator last);
 
 		Unordered_set(const Unordered_set& ust);
 		Unordered_set& operator=(const Unordered_set& ust);
+		~Unordered_set();
 
 		size_type size()const;
 		bool empty()const;
@@ -94,43 +460,198 @@ namespace miniSTL
 		float load_factor()const;
 		float max_load_factor()const;
 		void max_load_factor(float z);
+		//erase by key shrinks the table once the load drops below z, z is capped at max_load_factor() / 8.
+		//the rebuild aims for half max_load_factor(), far from both bounds, so alternating inserts
+		//and erases do not rebuild it back and forth. 0, the default, never shrinks
+		float min_load_factor()const { return min_load_factor_; }
+		void min_load_factor(float z);
 
+		//only ever grows the table
 		void rehash(size_type n);
+		//room for n keys before the next rehash
+		void reserve(size_type n);
+		//the fewest buckets that hold size() keys within max_load_factor(), e.g. after clear()
+		void shrink_to_fit();
+
+		//a growing table keeps the old bucket array next to the new one and moves a few buckets per
+		//insert/find/erase, lookups search both until the old one drains, so no single operation
+		//relinks the whole table. while that runs those operations may move nodes and invalidate
+		//iterators, references stay valid
+		bool incremental_rehash()const { return incremental_; }
+		void incremental_rehash(bool enable);
+		bool rehashing()const { return !old_buckets_.empty(); }
+
+		//a lookup tests the key against a blocked Bloom filter first and only walks the bucket on a hit,
+		//so a miss usually costs one 32 byte block. the filter is sized for bucket_count() *
+		//max_load_factor() keys, rebuilt with the table and refilled once as many keys were erased
+		bool bloom_filter()const { return !filter_.empty(); }
+		void bloom_filter(bool enable);
 
 		iterator begin();
 		iterator end();
+		const_iterator begin()const;
+		const_iterator end()const;
 
 		local_iterator begin(size_type i);
 		local_iterator end(size_type i);
 
 		iterator find(const key_type& key);
+		//hash is hash_function()(key), computed once by a caller probing many sets
+		iterator find(const key_type& key, size_type hash);
 		size_type count(const key_type& key);
-		
+		size_type count(const key_type& key, size_type hash);
+
+		//only when Hash and EqualKey both declare is_transparent: any key type they accept,
+		//e.g. a const char* against std::string keys, so no temporary Key is built
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, iterator>::type find(const K& key);
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, iterator>::type find(const K& key, size_type hash);
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, size_type>::type count(const K& key);
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, size_type>::type count(const K& key, size_type hash);
+
+		//one result per key, in the order of the keys. keys are probed in groups, each group is
+		//hashed and its buckets and first nodes prefetched before any key is compared
+		template <class ForwardIterator, class OutputIterator>
+		OutputIterator find_batch(ForwardIterator first, ForwardIterator last, OutputIterator result);
+		template <class ForwardIterator, class OutputIterator>
+		OutputIterator contains_batch(ForwardIterator first, ForwardIterator last, OutputIterator result);
+		//number of keys in [first, last) present in the set
+		template <class ForwardIterator>
+		size_type count_batch(ForwardIterator first, ForwardIterator last);
+
 		miniSTL::pair<iterator, bool> insert(const value_type& val);
+		//hash is hash_function() of the key of val
+		miniSTL::pair<iterator, bool> insert(const value_type& val, size_type hash);
 
+		//a forward range is counted first, the table grows once and the load factor is not checked again
 		template<class InputIterator>
 		void insert(InputIterator first, InputIterator last);
 
+		//never shrinks the table, so erasing while iterating stays valid
 		iterator erase(iterator position);
 		size_type erase(const key_type& key);
+		template <class K>
+		typename Detail::ust_enable_transparent<Hash, EqualKey, K, size_type>::type erase(const K& key);
+
+		//moves the nodes of other whose keys are not here into this set, without copying them,
+		//the keys already present stay in other
+		void merge(Unordered_set& other);
+		//the keys in both sets, found by probing the larger set with the keys of the smaller one
+		//in prefetched groups like the _batch lookups. given threads > 1 the probing is split over
+		//bucket ranges run on their own threads, the copies into the result are made on this one
+		Unordered_set intersect(const Unordered_set& other, size_type threads = 1)const;
+		//the keys of this set that are not in other, probed and threaded as in intersect()
+		Unordered_set difference(const Unordered_set& other, size_type threads = 1)const;
+		//copies the keys of this set that dst lacks into dst, which grows once for all of them,
+		//probed and threaded as in intersect()
+		void union_into(Unordered_set& dst, size_type threads = 1)const;
 
 		haser hash_function()const;
 		equal_key key_eq()const;
 		allocator_type get_allocator()const;
 
+		void swap(Unordered_set& ust);
 		void clear();
 
 	private:
-		size_type next_prime(size_type n)const;
 		size_type bucket_index(const key_type& key)const;
-		bool has_key(const key_type& key);
+		size_type bucket_index_of_hash(size_type hash)const { return policy_.index(hash); }
+
+		template <class... Args>
+		nodeptr newNode(Args&&... args);
+		void deleteNode(nodeptr p);
+		void copyBuckets(const Unordered_set& ust);
+		void cloneChains(bucket_vector& dst, const bucket_vector& src);
+
+		//bucket i of the new table, or bucket i - bucket_count() of the old one while migrating
+		size_type totalBuckets()const { return buckets_.size() + old_buckets_.size(); }
+		node_base*& bucketAt(size_type i) { return i < buckets_.size() ? buckets_[i] : old_buckets_[i - buckets_.size()]; }
+		node_base* bucketAt(size_type i)const { return i < buckets_.size() ? buckets_[i] : old_buckets_[i - buckets_.size()]; }
+		//first non-empty bucket at or after i in the same numbering, totalBuckets() if none
+		size_type nextBucket(size_type i)const;
+		void markEmpty(size_type i);
+
+		static void linkFront(bucket_vector& buckets, bitmap_vector& occupied,
+			size_type index, node_base* p);
+
+		void relinkChain(node_base* p, bucket_vector& buckets, bitmap_vector& occupied,
+			const Policy& policy);
+		void rehashStep();
+		void finishRehash();
+		void rebuild(size_type count, bool incremental);
+		//buckets needed for n keys at max_load_factor()
+		size_type bucketsFor(size_type n)const;
+		void shrinkIfSparse();
+
+		//a filter sized for bucket_count buckets filled to max_load_factor(), or none if switched off
+		void resetFilter(size_type bucket_count);
+		void refillFilter();
+		bool mayContain(size_type hash)const;
+		void addToFilter(size_type hash);
+		//n keys left the set, the filter is refilled once they outnumber what it was sized for
+		void noteErased(size_type n);
+
+		//a node of this set picked by a probe of another set, with its hash
+		struct match {
+			const node_base* node;
+			size_type hash;
+		};
+		//grown by the probing threads side by side, so never drawn from the pool of alloc
+		typedef miniSTL::vector<match, miniSTL::malloc_allocator<match>> match_vector;
+		//the nodes in buckets [from, to) whose key is, or with present false is not, in other
+		void collectMatches(const Unordered_set& other, bool present, size_type from, size_type to, match_vector& out)const;
+		//the same over all buckets, split into threads ranges probed side by side
+		void collectMatches(const Unordered_set& other, bool present, size_type threads, match_vector& out)const;
+		Unordered_set fromMatches(const match_vector& matches)const;
+		//link a copy of p, known to be absent, into the new table
+		void linkCopy(const node_base* p, size_type hash);
+		void prefetchProbe(size_type hash)const;
+
+		void storeHash(nodeptr p, size_type hash, std::true_type) { p->hash = hash; }
+		void storeHash(nodeptr, size_type, std::false_type) {}
+		size_type nodeHash(const node_base* p, std::true_type)const { return static_cast<const node*>(p)->hash; }
+		size_type nodeHash(const node_base* p, std::false_type)const { return hash_(keyOf(static_cast<const node*>(p)->value)); }
+		bool hashMatches(const node_base* p, size_type hash, std::true_type)const { return static_cast<const node*>(p)->hash == hash; }
+		bool hashMatches(const node_base*, size_type, std::false_type)const { return true; }
+
+		template <class V>
+		static auto keyOf(const V& v) -> decltype(ExtractKey()(v)) { return ExtractKey()(v); }
+
+		//insert a node built from args unless key, whose hash is given, is already present
+		template <class K, class... Args>
+		miniSTL::pair<iterator, bool> emplaceHashed(const K& key, size_type hash, Args&&... args);
+
+		template <class K>
+		node_base* findInChain(node_base* p, const K& key, size_type hash)const;
+		template <class K>
+		node_base* findNode(const K& key, size_type hash, size_type& index)const;
+		template <class K>
+		iterator findHashed(const K& key, size_type hash);
+		template <class K>
+		size_type eraseKey(const K& key);
+		template <class ForwardIterator, class Visit>
+		void probeBatch(ForwardIterator first, ForwardIterator last, Visit visit);
+
+		void initBuckets(size_type n);
+		template <class InputIterator>
+		void buildFrom(InputIterator first, InputIterator last, Detail::ust_single_pass);
+		template <class ForwardIterator>
+		void buildFrom(ForwardIterator first, ForwardIterator last, Detail::ust_multi_pass);
+		template <class InputIterator>
+		void insertRange(InputIterator first, InputIterator last, Detail::ust_single_pass);
+		template <class ForwardIterator>
+		void insertRange(ForwardIterator first, ForwardIterator last, Detail::ust_multi_pass);
+		template <class ForwardIterator>
+		void insertBulk(ForwardIterator first, ForwardIterator last);
 
 	public:
-		template<class Key, class Hash, class KeyEqual, class Allocator>
-		friend void swap(Unordered_set<Key, Hash, KeyEqual, Allocator>& lhs,
-			Unordered_set<Key, Hash, KeyEqual, Allocator>& rhs);
+		template<class K, class H, class E, class A, class P, class X>
+		friend void swap(Unordered_set<K, H, E, A, P, X>& lhs, Unordered_set<K, H, E, A, P, X>& rhs);
 	};
 }
 
 #include "Detail\Unordered_set.impl.h"
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,107 @@
+#ifndef _UNORDERED_SET_IMAGE_H_
+#define _UNORDERED_SET_IMAGE_H_
+
+#include "Unordered_set.h"
+
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+
+namespace miniSTL
+{
+	namespace Detail
+	{
+		//first 48 bytes of an image, in the byte order of the machine that wrote it
+		struct usi_header {
+			char magic[8];
+			uint32_t version;
+			uint32_t key_size;
+			uint32_t byte_order; //usi_byte_order as written, reads back swapped on the other endianness
+			uint32_t reserved;
+			uint64_t size;
+			uint64_t bucket_count;
+			uint64_t keys_offset; //byte offset of the key array, a multiple of 64
+		};
+
+		const char usi_magic[8] = { 'm', 'i', 'n', 'i', 'U', 'S', 'I', '\0' };
+		const uint32_t usi_version = 1;
+		const uint32_t usi_byte_order = 0x01020304;
+	}
+
+	/*
+	 * Unordered_set_image
+	 * a read-only set of trivially copyable keys over one contiguous block of memory, meant to be
+	 * written once by write() and then mapped straight from disk, e.g. through Mapped_file.
+	 * the image is a header, bucket_count() + 1 offsets and the key array grouped by bucket, so
+	 * bucket b holds keys [offsets[b], offsets[b + 1]). opening it only checks the header, nothing
+	 * is copied or rebuilt. a lookup hashes the key, picks the bucket through Policy exactly as
+	 * Unordered_set does and scans a run of adjacent keys, so a miss or a hit costs one offset
+	 * load and usually one cache line of keys.
+	 * Hash must give the same value in the writing and the reading process, std::hash on
+	 * integers does. the image keeps the byte order and key layout of the writer.
+	 */
+	template <class Key, class Hash = std::hash<Key>, class EqualKey = miniSTL::equal_to<Key>,
+	class Policy = prime_bucket_policy>
+	class Unordered_set_image
+	{
+		static_assert(std::is_trivially_copyable<Key>::value, "image keys are stored and loaded as raw bytes");
+
+	public:
+		typedef Key key_type;
+		typedef Key value_type;
+		typedef size_t size_type;
+		typedef Hash haser;
+		typedef EqualKey equal_key;
+		typedef Policy bucket_policy;
+		typedef const Key* const_iterator;
+		typedef const_iterator iterator;
+
+	private:
+		const uint64_t* offsets_;
+		const Key* keys_;
+		size_type size_;
+		size_type bucket_count_;
+		Policy policy_;
+		haser hash_;
+		equal_key equal_;
+
+	public:
+		//data must stay mapped while the image is used and be aligned to 8 bytes, a mapping always is
+		Unordered_set_image(const void* data, size_type bytes, const haser& hash = haser(), const equal_key& equal = equal_key());
+
+		//false if the block is not an image of this Key written on a machine like this one
+		bool valid()const { return keys_ != nullptr; }
+
+		size_type size()const { return size_; }
+		bool empty()const { return size_ == 0; }
+		size_type bucket_count()const { return bucket_count_; }
+		float load_factor()const { return bucket_count_ ? static_cast<float>(size_) / bucket_count_ : 0; }
+
+		//the keys in bucket order
+		const_iterator begin()const { return keys_; }
+		const_iterator end()const { return keys_ + size_; }
+
+		const_iterator find(const key_type& key)const { return find(key, hash_(key)); }
+		//hash is hash_function()(key)
+		const_iterator find(const key_type& key, size_type hash)const;
+		size_type count(const key_type& key)const { return find(key) != end() ? 1 : 0; }
+		size_type count(const key_type& key, size_type hash)const { return find(key, hash) != end() ? 1 : 0; }
+
+		haser hash_function()const { return hash_; }
+		equal_key key_eq()const { return equal_; }
+
+		//writes the distinct keys of [first, last) as an image with up to about load keys per bucket,
+		//the buckets are counted for the whole range, duplicates included. false if load is not
+		//positive or the stream failed
+		template <class ForwardIterator>
+		static bool write(std::ostream& out, ForwardIterator first, ForwardIterator last, float load = 4.0f,
+			const haser& hash = haser(), const equal_key& equal = equal_key());
+		template <class Allocator>
+		static bool write(std::ostream& out, const Unordered_set<Key, Hash, EqualKey, Allocator, Policy>& set, float load = 4.0f) {
+			return write(out, set.begin(), set.end(), load, set.hash_function(), set.key_eq());
+		}
+	};
+}
+
+#include "Detail\Unordered_set_image.impl.h"
+#endif
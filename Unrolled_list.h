@@ -0,0 +1,214 @@
+#ifndef _UNROLLED_LIST_H_
+#define _UNROLLED_LIST_H_
+
+#include "Allocator.h"
+#include "Iterator.h"
+#include "Functional.h"
+#include "Utility.h"
+#include <type_traits>
+#include <utility>
+
+namespace miniSTL
+{
+	namespace Detail
+	{
+		//default number of elements per node, keeps a node around 256 bytes
+		template <class T>
+		struct ul_default_capacity {
+			static const size_t value = (256 / sizeof(T) < 4) ? 4 : 256 / sizeof(T);
+		};
+
+		//links only, the list header is one of these so end() holds no element
+		struct ul_node_base {
+			ul_node_base* prev;
+			ul_node_base* next;
+		};
+
+		//a node stores up to N elements contiguously in [0, count)
+		template <class T, size_t N>
+		struct ul_node : public ul_node_base {
+			size_t count;
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[N];
+
+			T* data() { return reinterpret_cast<T*>(slots); }
+			const T* data() const { return reinterpret_cast<const T*>(slots); }
+		};
+
+		//class of iterator
+		template <class T, size_t N, class Ref, class Ptr>
+		struct ul_iterator : public iterator<bidirectional_iterator_tag, T>
+		{
+		public:
+			typedef ul_node<T, N>* nodeptr;
+			typedef Ref reference;
+			typedef Ptr pointer;
+
+			ul_node_base* node_;
+			size_t index_;
+
+		public:
+			ul_iterator(ul_node_base* node = nullptr, size_t index = 0) : node_(node), index_(index) {}
+			ul_iterator(const ul_iterator<T, N, T&, T*>& it) : node_(it.node_), index_(it.index_) {}
+
+			ul_iterator& operator++();
+			ul_iterator operator++(int);
+			ul_iterator& operator--();
+			ul_iterator operator--(int);
+
+			reference operator *() const { return static_cast<nodeptr>(node_)->data()[index_]; }
+			pointer operator ->() const { return &operator*(); }
+
+			bool operator == (const ul_iterator& it) const { return node_ == it.node_ && index_ == it.index_; }
+			bool operator != (const ul_iterator& it) const { return !(*this == it); }
+		};
+	}
+	//end of Detail
+
+	/*
+	 * unrolled_list
+	 * a doubly linked list of small arrays, each node holds up to NodeCapacity elements,
+	 * so iteration walks contiguous memory and pays one pointer chase per node instead of per element.
+	 * iterators are invalidated by insert and erase, elements may move inside or between nodes.
+	 */
+	template <class T, size_t NodeCapacity = Detail::ul_default_capacity<T>::value>
+	class unrolled_list
+	{
+		static_assert(NodeCapacity >= 2, "unrolled_list needs at least two elements per node");
+
+	private:
+		typedef Detail::ul_node_base node_base;
+		typedef Detail::ul_node<T, NodeCapacity> node;
+		typedef node* nodeptr;
+		typedef allocator<node> nodeAllocator;
+
+	public:
+		typedef T value_type;
+		typedef Detail::ul_iterator<T, NodeCapacity, T&, T*> iterator;
+		typedef Detail::ul_iterator<T, NodeCapacity, const T&, const T*> const_iterator;
+		typedef T& reference;
+		typedef const T& const_reference;
+		typedef size_t size_type;
+
+	private:
+		node_base header_;
+		size_type size_;
+
+	public:
+		unrolled_list();
+		explicit unrolled_list(size_type n, const value_type& val = value_type());
+
+		template<class InputIterator>
+		unrolled_list(InputIterator first, InputIterator last);
+
+		unrolled_list(const unrolled_list& l);
+		unrolled_list(unrolled_list&& l);
+		unrolled_list& operator = (const unrolled_list& l);
+		unrolled_list& operator = (unrolled_list&& l);
+		~unrolled_list();
+
+		bool empty() const { return size_ == 0; }
+		size_type size() const { return size_; }
+		static size_type node_capacity() { return NodeCapacity; }
+
+		reference front() { return *begin(); }
+		reference back() { return *(--end()); }
+		const_reference front() const { return *begin(); }
+		const_reference back() const { return *(--end()); }
+
+		void push_front(const value_type& val);
+		void push_front(value_type&& val);
+		void pop_front();
+
+		void push_back(const value_type& val);
+		void push_back(value_type&& val);
+		void pop_back();
+
+		iterator begin() { return iterator(header_.next, 0); }
+		iterator end() { return iterator(&header_, 0); }
+		const_iterator begin() const { return const_iterator(header_.next, 0); }
+		const_iterator end() const { return const_iterator(const_cast<node_base*>(&header_), 0); }
+
+		iterator insert(iterator position, const value_type& val);
+		iterator insert(iterator position, value_type&& val);
+		void insert(iterator position, size_type n, const value_type& val);
+
+		template<class InputIterator>
+		void insert(iterator position, InputIterator first, InputIterator last);
+
+		iterator erase(iterator position);
+		iterator erase(iterator first, iterator last);
+
+		void swap(unrolled_list& l);
+		void clear();
+
+		void splice(iterator position, unrolled_list& l);
+		void splice(iterator position, unrolled_list& l, iterator i);
+		void splice(iterator position, unrolled_list& l, iterator first, iterator last);
+
+		void remove(const value_type& val);
+
+		template<class Predicate>
+		void remove_if(Predicate pred);
+
+		void unique();
+
+		template <class BinaryPredicate>
+		void unique(BinaryPredicate binary_pred);
+
+		void merge(unrolled_list& l);
+
+		template <class Compare>
+		void merge(unrolled_list& l, Compare comp);
+
+		void sort();
+
+		template <class Compare>
+		void sort(Compare comp);
+
+		void reverse();
+
+	private:
+		void init();
+		void ctorAux(size_type n, const value_type& val, std::true_type);
+
+		template <class InputIterator>
+		void ctorAux(InputIterator first, InputIterator last, std::false_type);
+
+		nodeptr newNode();
+		void deleteNode(nodeptr p);
+		void linkBefore(node_base* position, node_base* p);
+		void unlink(node_base* p);
+		void fixHeader();
+		nodeptr splitNode(nodeptr p, size_type at);
+
+		template <class U>
+		iterator insertAux(iterator position, U&& val);
+
+		void truncate(iterator position);
+		void transferNodes(node_base* position, unrolled_list& l);
+		void consume(iterator& it);
+		size_type offsetOf(iterator position) const;
+		iterator iteratorAt(size_type offset);
+
+		template <class Compare>
+		static void sortNode(nodeptr p, Compare comp);
+
+		void insert_aux(iterator position, size_type n, const T& val, std::true_type);
+
+		template <class InputIterator>
+		void insert_aux(iterator position, InputIterator first, InputIterator last, std::false_type);
+
+	public:
+		template <class U, size_t M>
+		friend void swap(unrolled_list<U, M>& x, unrolled_list<U, M>& y);
+
+		template <class U, size_t M>
+		friend bool operator==(const unrolled_list<U, M>& lhs, const unrolled_list<U, M>& rhs);
+
+		template <class U, size_t M>
+		friend bool operator!=(const unrolled_list<U, M>& lhs, const unrolled_list<U, M>& rhs);
+	};
+}
+
+#include "Detail\Unrolled_list.impl.h"
+#endif // _UNROLLED_LIST_H_
@@ -1,6 +1,8 @@
 #ifndef _UTILITY_H_
 #define _UTILITY_H_
 
+#include <utility>
+
 namespace miniSTL
 {
 	template <class T>
@@ -11,6 +13,10 @@ namespace miniSTL
 		b = temp;
 	}
 
+	//selects the pair constructor that builds second in place from the remaining arguments
+	struct construct_second_t {};
+	const construct_second_t construct_second = construct_second_t();
+
 	template<class T1, class T2>
 	struct pair {
 	public:
@@ -24,6 +30,8 @@ namespace miniSTL
 		template<class U, class V>
 		pair(const pair<U, V>& pr);
 		pair(const first_type& a, const second_type& b);
+		template<class U, class... Args>
+		pair(construct_second_t, U&& a, Args&&... args);
 		pair& operator= (const pair& pr);
 		void swap(pair& pr);
 	public:
@@ -49,6 +57,10 @@ namespace miniSTL
 	template<class T1, class T2>
 	pair<T1, T2>::pair(const first_type& a, const second_type& b) : first(a), second(b) {}
 	template<class T1, class T2>
+	template<class U, class... Args>
+	pair<T1, T2>::pair(construct_second_t, U&& a, Args&&... args)
+		: first(std::forward<U>(a)), second(std::forward<Args>(args)...) {}
+	template<class T1, class T2>
 	pair<T1, T2>& pair<T1, T2>::operator =(const pair<T1, T2>& pr) {
 		if (this != &pr) {
 			first = pr.first;
@@ -73,7 +73,7 @@ namespace miniSTL
 
 		//访问元素相关
 		reference operator[](const difference_type i) { return *(begin() + i); }
-		const_reference operator[](const difference_type i) const { return *(cbegin + i); }
+		const_reference operator[](const difference_type i) const { return *(cbegin() + i); }
 		reference front() { return *(begin()); }
 		reference back() { return *(end() - 1); }
 		pointer data() { return start_; }
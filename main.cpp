@@ -6,6 +6,15 @@
 #include "Test\ListTest.h"
 #include "Test\QueueTest.h"
 #include "Test\PriorityQueueTest.h"
+#include "Test\Indexed_priority_queueTest.h"
+#include "Test\Unrolled_listTest.h"
+#include "Test\Intrusive_listTest.h"
+#include "Test\Flat_hash_setTest.h"
+#include "Test\Unordered_mapTest.h"
+#include "Test\Concurrent_unordered_setTest.h"
+#include "Test\Unordered_set_imageTest.h"
+#include "Test\Concurrent_priority_queueTest.h"
+#include "Test\Benchmark.h"
 
 int main(void)
 {
@@ -15,4 +24,16 @@ int main(void)
 	miniSTL::ListTest::testAllCases();
 	miniSTL::QueueTest::testAllCases();
 	miniSTL::PriorityQueueTest::testAllCases();
+	miniSTL::Indexed_priority_queueTest::testAllCases();
+	miniSTL::Unrolled_listTest::testAllCases();
+	miniSTL::Intrusive_listTest::testAllCases();
+	miniSTL::Flat_hash_setTest::testAllCases();
+	miniSTL::Unordered_mapTest::testAllCases();
+	miniSTL::Concurrent_unordered_setTest::testAllCases();
+	miniSTL::Unordered_set_imageTest::testAllCases();
+	miniSTL::Concurrent_priority_queueTest::testAllCases();
+
+#ifdef MINISTL_BENCHMARK
+	miniSTL::Benchmark::runAll();
+#endif
 }